@@ -1330,6 +1330,45 @@ const std::string& fs::get_config_dir()
 	return s_dir;
 }
 
+const std::string& fs::get_executable_path()
+{
+	// Use magic static
+	static const std::string s_path = []
+	{
+		std::string path;
+
+#ifdef _WIN32
+		wchar_t buf[2048];
+		if (GetModuleFileName(NULL, buf, ::size32(buf)) - 1 >= ::size32(buf) - 1)
+		{
+			return path; // empty
+		}
+
+		to_utf8(path, buf); // Convert to UTF-8
+
+		std::replace(path.begin(), path.end(), '\\', '/');
+#elif defined(__APPLE__)
+		char buf[4096];
+		u32 size = sizeof(buf);
+		if (_NSGetExecutablePath(buf, &size) == 0)
+		{
+			path = buf;
+		}
+#else
+		char buf[4096];
+		const ssize_t size = ::readlink("/proc/self/exe", buf, sizeof(buf));
+		if (size > 0 && static_cast<std::size_t>(size) < sizeof(buf))
+		{
+			path.assign(buf, size);
+		}
+#endif
+
+		return path;
+	}();
+
+	return s_path;
+}
+
 std::string fs::get_data_dir(const std::string& prefix, const std::string& location, const std::string& suffix)
 {
 	static const std::string s_dir = []
@@ -482,6 +482,9 @@ namespace fs
 	// Get configuration directory
 	const std::string& get_config_dir();
 
+	// Get full path of the running executable (empty if unknown)
+	const std::string& get_executable_path();
+
 	// Get data/cache directory for specified prefix and suffix
 	std::string get_data_dir(const std::string& prefix, const std::string& location, const std::string& suffix);
 
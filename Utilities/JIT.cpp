@@ -355,6 +355,239 @@ struct EventListener : llvm::JITEventListener
 	}
 };
 
+// Packed object cache (single file per cache directory, mapped on first use)
+class ObjectPack final
+{
+	struct header_t
+	{
+		u64 magic;
+		u32 version;
+		u32 reserved;
+	};
+
+	// Object record: header, name and data (both aligned to 16 bytes)
+	struct entry_t
+	{
+		u32 name_size;
+		u32 data_size;
+		u64 checksum; // See get_checksum()
+	};
+
+	static constexpr u64 c_magic = 0x4b4341504d564c4c; // "LLVMPACK"
+	static constexpr u32 c_version = 2;
+
+	// FNV-1a 64-bit over the sizes and 8-byte words of the padded name and data
+	static u64 get_checksum(const entry_t& entry, const char* body, u64 size)
+	{
+		u64 hash = (14695981039346656037ull ^ (u64{entry.name_size} << 32 | entry.data_size)) * 1099511628211ull;
+
+		for (u64 i = 0; i < size; i += 8)
+		{
+			u64 word;
+			std::memcpy(&word, body + i, sizeof(word));
+			hash = (hash ^ word) * 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	const std::string m_path;
+
+	shared_mutex m_mutex;
+
+	fs::file m_file;
+
+	// Read-only view of the file as it was at opening
+	const char* m_view = nullptr;
+	u64 m_view_size = 0;
+
+#ifdef _WIN32
+	HANDLE m_map = nullptr;
+#endif
+
+	// End of the last valid record
+	u64 m_end = 0;
+
+	// Object name -> object data (points to the view or to m_added)
+	std::unordered_map<std::string, llvm::StringRef> m_index;
+
+	// Objects appended after the file was mapped
+	std::deque<std::string> m_added;
+
+	ObjectPack(const std::string& path)
+		: m_path(path)
+	{
+		if (!m_file.open(path + "llvm.pack", fs::read + fs::write + fs::create))
+		{
+			LOG_ERROR(GENERAL, "LLVM: Failed to open object pack in %s (%s)", path, fs::g_tls_error);
+			return;
+		}
+
+		const u64 size = m_file.size();
+
+		header_t header{};
+
+		if (size < sizeof(header_t) || !m_file.read(header) || header.magic != c_magic || header.version != c_version)
+		{
+			// Initialize new pack
+			header = {c_magic, c_version, 0};
+			m_file.trunc(0);
+			m_file.seek(0);
+			m_file.write(header);
+			m_end = sizeof(header_t);
+			return;
+		}
+
+		m_end = sizeof(header_t);
+
+#ifdef _WIN32
+		m_map = ::CreateFileMappingW(m_file.get_handle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+		m_view = m_map ? static_cast<const char*>(::MapViewOfFile(m_map, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+		const auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, m_file.get_handle(), 0);
+		m_view = ptr != MAP_FAILED ? static_cast<const char*>(ptr) : nullptr;
+#endif
+
+		if (!m_view)
+		{
+			// Records can't be indexed, appending after the header would overwrite them
+			LOG_ERROR(GENERAL, "LLVM: Failed to map object pack in %s (objects will not be saved)", path);
+			m_file.close();
+			return;
+		}
+
+		m_view_size = size;
+
+		// Build index
+		while (m_end + sizeof(entry_t) <= m_view_size)
+		{
+			entry_t entry;
+			std::memcpy(&entry, m_view + m_end, sizeof(entry_t));
+
+			const u64 name_pos = m_end + sizeof(entry_t);
+			const u64 data_pos = name_pos + ::align<u64>(entry.name_size, 16);
+			const u64 next = data_pos + ::align<u64>(entry.data_size, 16);
+
+			if (next > m_view_size || !entry.data_size)
+			{
+				// Incomplete record (will be overwritten)
+				LOG_WARNING(GENERAL, "LLVM: Object pack in %s is truncated at 0x%llx", path, m_end);
+				break;
+			}
+
+			if (entry.checksum != get_checksum(entry, m_view + name_pos, next - name_pos))
+			{
+				// Torn or corrupted record, this and the following records will be overwritten
+				LOG_ERROR(GENERAL, "LLVM: Object pack in %s is corrupted at 0x%llx", path, m_end);
+				break;
+			}
+
+			m_index[std::string(m_view + name_pos, entry.name_size)] = llvm::StringRef(m_view + data_pos, entry.data_size);
+			m_end = next;
+		}
+
+		LOG_NOTICE(GENERAL, "LLVM: Mapped object pack in %s (%zu objects)", path, m_index.size());
+	}
+
+public:
+	ObjectPack(const ObjectPack&) = delete;
+
+	~ObjectPack()
+	{
+#ifdef _WIN32
+		if (m_view) ::UnmapViewOfFile(m_view);
+		if (m_map) ::CloseHandle(m_map);
+#else
+		if (m_view) ::munmap(const_cast<char*>(m_view), m_view_size);
+#endif
+	}
+
+	// Get pack for the cache directory
+	static ObjectPack& get(const std::string& path)
+	{
+		static shared_mutex s_packs_mutex;
+		static std::unordered_map<std::string, std::unique_ptr<ObjectPack>> s_packs;
+
+		writer_lock lock(s_packs_mutex);
+
+		auto& pack = s_packs[path];
+
+		if (!pack)
+		{
+			pack.reset(new ObjectPack(path));
+		}
+
+		return *pack;
+	}
+
+	// Find object data (empty if not found)
+	llvm::StringRef find(const std::string& name)
+	{
+		{
+			reader_lock lock(m_mutex);
+
+			const auto found = m_index.find(name);
+
+			if (found != m_index.end())
+			{
+				return found->second;
+			}
+		}
+
+		// Import loose object file (written by older versions)
+		if (fs::file loose{m_path + name})
+		{
+			const std::string data = loose.to_string();
+
+			if (data.size())
+			{
+				return add(name, data);
+			}
+		}
+
+		return {};
+	}
+
+	// Append object to the pack
+	llvm::StringRef add(const std::string& name, llvm::StringRef obj)
+	{
+		writer_lock lock(m_mutex);
+
+		m_added.emplace_back(obj.data(), obj.size());
+
+		const llvm::StringRef result = m_index[name] = m_added.back();
+
+		if (!m_file)
+		{
+			return result;
+		}
+
+		entry_t entry{};
+		entry.name_size = ::size32(name);
+		entry.data_size = static_cast<u32>(obj.size());
+
+		const u64 data_pos = sizeof(entry_t) + ::align<u64>(entry.name_size, 16);
+
+		// Write the whole record at once
+		std::vector<char> record(data_pos + ::align<u64>(entry.data_size, 16));
+		std::memcpy(record.data() + sizeof(entry_t), name.data(), name.size());
+		std::memcpy(record.data() + data_pos, obj.data(), obj.size());
+		entry.checksum = get_checksum(entry, record.data() + sizeof(entry_t), record.size() - sizeof(entry_t));
+		std::memcpy(record.data(), &entry, sizeof(entry_t));
+
+		m_file.seek(m_end);
+
+		if (m_file.write(record.data(), record.size()) != record.size())
+		{
+			LOG_ERROR(GENERAL, "LLVM: Failed to write object pack in %s (%s)", m_path, fs::g_tls_error);
+			return result;
+		}
+
+		m_end += record.size();
+		return result;
+	}
+};
+
 // Helper class
 class ObjectCache final : public llvm::ObjectCache
 {
@@ -370,19 +603,18 @@ public:
 
 	void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) override
 	{
-		std::string name = m_path;
-		name.append(module->getName());
-		fs::file(name, fs::rewrite).write(obj.getBufferStart(), obj.getBufferSize());
+		ObjectPack::get(m_path).add(module->getName().str(), obj.getBuffer());
 		LOG_SUCCESS(GENERAL, "LLVM: Created module: %s", module->getName().data());
 	}
 
-	static std::unique_ptr<llvm::MemoryBuffer> load(const std::string& path)
+	static std::unique_ptr<llvm::MemoryBuffer> load(const std::string& path, const std::string& name)
 	{
-		if (fs::file cached{path, fs::read})
+		const auto obj = ObjectPack::get(path).find(name);
+
+		if (!obj.empty())
 		{
-			auto buf = llvm::MemoryBuffer::getNewUninitMemBuffer(cached.size());
-			cached.read(const_cast<char*>(buf->getBufferStart()), buf->getBufferSize());
-			return buf;
+			// Zero-copy buffer (the pack is never unloaded)
+			return llvm::MemoryBuffer::getMemBuffer(obj, name, false);
 		}
 
 		return nullptr;
@@ -390,10 +622,7 @@ public:
 
 	std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override
 	{
-		std::string path = m_path;
-		path.append(module->getName());
-
-		if (auto buf = load(path))
+		if (auto buf = load(m_path, module->getName().str()))
 		{
 			LOG_SUCCESS(GENERAL, "LLVM: Loaded module: %s", module->getName().data());
 			return buf;
@@ -485,9 +714,28 @@ void jit_compiler::add(std::unique_ptr<llvm::Module> module, const std::string&
 	}
 }
 
-void jit_compiler::add(const std::string& path)
+void jit_compiler::add(const std::string& path, const std::string& name)
+{
+	auto buf = ObjectCache::load(path, name);
+
+	if (!buf)
+	{
+		fmt::throw_exception("LLVM: Object not found: %s%s" HERE, path, name);
+	}
+
+	auto obj = llvm::object::ObjectFile::createObjectFile(*buf);
+
+	if (!obj)
+	{
+		fmt::throw_exception("LLVM: Invalid object: %s%s" HERE, path, name);
+	}
+
+	m_engine->addObjectFile(llvm::object::OwningBinary<llvm::object::ObjectFile>(std::move(*obj), std::move(buf)));
+}
+
+bool jit_compiler::check(const std::string& path, const std::string& name)
 {
-	m_engine->addObjectFile(std::move(llvm::object::ObjectFile::createObjectFile(*ObjectCache::load(path)).get()));
+	return !ObjectPack::get(path).find(name).empty();
 }
 
 void jit_compiler::fin()
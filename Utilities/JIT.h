@@ -52,8 +52,11 @@ public:
 	// Add module (path to obj cache dir)
 	void add(std::unique_ptr<llvm::Module> module, const std::string& path);
 
-	// Add object (path to obj file)
-	void add(const std::string& path);
+	// Add object from the object pack (path to obj cache dir, object name)
+	void add(const std::string& path, const std::string& name);
+
+	// Check whether the object pack contains the object (path to obj cache dir, object name)
+	static bool check(const std::string& path, const std::string& name);
 
 	// Finalize
 	void fin();
@@ -1368,6 +1368,12 @@ static LONG exception_handler(PEXCEPTION_POINTERS pExp)
 	const u64 exec64 = pExp->ExceptionRecord->ExceptionInformation[1] - (u64)vm::g_exec_addr;
 	const bool is_writing = pExp->ExceptionRecord->ExceptionInformation[0] != 0;
 
+	if (pExp->ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && vm::reservation_fault((void*)pExp->ExceptionRecord->ExceptionInformation[1]))
+	{
+		// Reservation stamps are committed on first access
+		return EXCEPTION_CONTINUE_EXECUTION;
+	}
+
 	if (pExp->ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && addr64 < 0x100000000ull)
 	{
 		if (thread_ctrl::get_current() && handle_access_violation((u32)addr64, is_writing, pExp->ContextRecord))
@@ -1504,6 +1510,12 @@ static void signal_handler(int sig, siginfo_t* info, void* uct)
 	const u64 exec64 = (u64)info->si_addr - (u64)vm::g_exec_addr;
 	const auto cause = is_writing ? "writing" : "reading";
 
+	if (vm::reservation_fault(info->si_addr))
+	{
+		// Reservation stamps are committed on first access
+		return;
+	}
+
 	if (addr64 < 0x100000000ull)
 	{
 		// Try to process access violation
@@ -3,6 +3,13 @@
 #include "types.h"
 #include <string>
 
+// Allow AVX2 code generation for a single function (must be guarded by utils::has_avx2())
+#ifdef _MSC_VER
+#define AVX2_FUNC
+#else
+#define AVX2_FUNC __attribute__((__target__("avx2")))
+#endif
+
 namespace utils
 {
 	inline std::array<u32, 4> get_cpuid(u32 func, u32 subfunc)
@@ -169,19 +169,21 @@ void mfc_thread::cpu_task()
 						// Store unconditionally
 						if (s_use_rtm && utils::transaction_enter())
 						{
-							if (!vm::reader_lock{ vm::try_to_lock })
+							if (!vm::reader_lock{ vm::try_to_lock } || !vm::reservation_lock{ cmd.eal, vm::try_to_lock })
 							{
 								_xabort(0);
 							}
 
 							data = to_write;
 							vm::reservation_update(cmd.eal, 128);
-							vm::notify(cmd.eal, 128);
 							_xend();
+
+							vm::notify(cmd.eal, 128);
 						}
 						else
 						{
-							vm::writer_lock lock(0);
+							vm::reservation_lock lock(cmd.eal);
+							vm::reservation_lock_stamp(cmd.eal, 128);
 							data = to_write;
 							vm::reservation_update(cmd.eal, 128);
 							vm::notify(cmd.eal, 128);
@@ -200,6 +202,9 @@ void mfc_thread::cpu_task()
 						{
 							cmd.lsa &= 0x3fff0;
 
+							// Pending merged transfer
+							spu_mfc_cmd batch{};
+
 							// try to get the whole list done in one go
 							while (cmd.size != 0)
 							{
@@ -218,7 +223,7 @@ void mfc_thread::cpu_task()
 									transfer.cmd = MFC(cmd.cmd & ~MFC_LIST_MASK);
 									transfer.size = size;
 
-									spu.do_dma_transfer(transfer);
+									spu.push_dma_batch(batch, transfer);
 									cmd.lsa += std::max<u32>(size, 16);
 								}
 
@@ -229,6 +234,7 @@ void mfc_thread::cpu_task()
 								// dont stall for last 'item' in list
 								if ((item.sb & 0x8000) && (cmd.size != 0))
 								{
+									spu.flush_dma_batch(batch);
 									spu.ch_stall_mask |= (1 << cmd.tag);
 									spu.ch_stall_stat.push_or(spu, 1 << cmd.tag);
 
@@ -241,6 +247,8 @@ void mfc_thread::cpu_task()
 									break;
 								}
 							}
+
+							spu.flush_dma_batch(batch);
 						}
 
 						if (cmd.size != 0 && (cmd.cmd & MFC_BARRIER_MASK))
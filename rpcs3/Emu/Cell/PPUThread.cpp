@@ -165,7 +165,7 @@ extern const ppu_decoder<ppu_interpreter_fast> g_ppu_interpreter_fast([](auto& t
 
 extern void ppu_initialize();
 extern void ppu_initialize(const ppu_module& info);
-static void ppu_initialize2(class jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name, u32 fragment_index, atomic_t<u32>&);
+static void ppu_initialize2(class jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name);
 extern void ppu_execute_syscall(ppu_thread& ppu, u64 code);
 
 // Get pointer to executable cache
@@ -948,7 +948,7 @@ extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value)
 
 	if (s_use_rtm && utils::transaction_enter())
 	{
-		if (!vm::reader_lock{vm::try_to_lock})
+		if (!vm::reader_lock{vm::try_to_lock} || !vm::reservation_lock{addr, vm::try_to_lock})
 		{
 			_xabort(0);
 		}
@@ -958,15 +958,20 @@ extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value)
 		if (result)
 		{
 			vm::reservation_update(addr, sizeof(u32));
-			vm::notify(addr, sizeof(u32));
 		}
 
 		_xend();
+
+		if (result)
+		{
+			vm::notify(addr, sizeof(u32));
+		}
+
 		ppu.raddr = 0;
 		return result;
 	}
 
-	vm::writer_lock lock(0);
+	vm::reservation_lock lock(addr);
 
 	const bool result = ppu.rtime == vm::reservation_acquire(addr, sizeof(u32)) && data.compare_and_swap_test(static_cast<u32>(ppu.rdata), reg_value);
 
@@ -992,7 +997,7 @@ extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value)
 
 	if (s_use_rtm && utils::transaction_enter())
 	{
-		if (!vm::reader_lock{vm::try_to_lock})
+		if (!vm::reader_lock{vm::try_to_lock} || !vm::reservation_lock{addr, vm::try_to_lock})
 		{
 			_xabort(0);
 		}
@@ -1002,15 +1007,20 @@ extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value)
 		if (result)
 		{
 			vm::reservation_update(addr, sizeof(u64));
-			vm::notify(addr, sizeof(u64));
 		}
 
 		_xend();
+
+		if (result)
+		{
+			vm::notify(addr, sizeof(u64));
+		}
+
 		ppu.raddr = 0;
 		return result;
 	}
 
-	vm::writer_lock lock(0);
+	vm::reservation_lock lock(addr);
 
 	const bool result = ppu.rtime == vm::reservation_acquire(addr, sizeof(u64)) && data.compare_and_swap_test(ppu.rdata, reg_value);
 
@@ -1035,57 +1045,10 @@ static bool adde_carry(u64 a, u64 b, bool c)
 #endif
 }
 
-extern void ppu_initialize()
-{
-	const auto _main = fxm::withdraw<ppu_module>();
-
-	if (!_main)
-	{
-		return;
-	}
-
-	// Initialize main module
-	ppu_initialize(*_main);
-
-	std::vector<lv2_prx*> prx_list;
-
-	idm::select<lv2_obj, lv2_prx>([&](u32, lv2_prx& prx)
-	{
-		prx_list.emplace_back(&prx);
-	});
-
-	// Initialize preloaded libraries
-	for (auto ptr : prx_list)
-	{
-		ppu_initialize(*ptr);
-	}
-}
-
-extern void ppu_initialize(const ppu_module& info)
+#ifdef LLVM_AVAILABLE
+// Link table
+static const std::unordered_map<std::string, u64>& ppu_get_link_table()
 {
-	if (g_cfg.core.ppu_decoder != ppu_decoder_type::llvm)
-	{
-		// Temporarily
-		s_ppu_toc = fxm::get_always<std::unordered_map<u32, u32>>().get();
-
-		for (const auto& func : info.funcs)
-		{
-			for (auto& block : func.blocks)
-			{
-				ppu_register_function_at(block.first, block.second, nullptr);
-			}
-
-			if (g_cfg.core.ppu_debug && func.size && func.toc != -1)
-			{
-				s_ppu_toc->emplace(func.addr, func.toc);
-				ppu_ref(func.addr) = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(&ppu_check_toc));
-			}
-		}
-
-		return;
-	}
-
-	// Link table
 	static const std::unordered_map<std::string, u64> s_link_table = []()
 	{
 		std::unordered_map<std::string, u64> link_table
@@ -1124,82 +1087,129 @@ extern void ppu_initialize(const ppu_module& info)
 		return link_table;
 	}();
 
-	// Get cache path for this executable
-	std::string cache_path;
+	return s_link_table;
+}
 
-	if (info.name.empty())
-	{
-		cache_path = Emu.GetCachePath();
-	}
-	else
-	{
-		cache_path = vfs::get("/dev_flash/");
+// Compiled PPU module info
+struct jit_module
+{
+	std::vector<u64*> vars;
+	std::vector<ppu_function_t> funcs;
+};
 
-		if (info.path.compare(0, cache_path.size(), cache_path) == 0)
-		{
-			// Remove prefix for dev_flash files
-			cache_path.clear();
-		}
-		else
-		{
-			cache_path = Emu.GetTitleID();
-		}
+// Module state shared by all its fragments during ppu_initialize
+struct ppu_jit_module_state
+{
+	const ppu_module& info;
 
-		cache_path = fs::get_data_dir(cache_path, info.path);
-	}
+	// Cache path for this executable
+	const std::string cache_path;
 
-#ifdef LLVM_AVAILABLE
-	// Compiled PPU module info
-	struct jit_module
-	{
-		std::vector<u64*> vars;
-		std::vector<ppu_function_t> funcs;
-	};
+	// Difference between function name and current location
+	const u32 reloc;
 
-	// Permanently loaded compiled PPU modules (name -> data)
-	jit_module& jit_mod = fxm::get_always<std::unordered_map<std::string, jit_module>>()->emplace(cache_path + info.name, jit_module{}).first->second;
+	// Permanently loaded compiled PPU module
+	jit_module& jit_mod;
 
 	// Compiler instance (deferred initialization)
 	std::shared_ptr<jit_compiler> jit;
 
-	// Compiler mutex (global)
-	static semaphore<> jmutex;
+	// Global variables to initialize
+	std::vector<std::pair<std::string, u64>> globals;
 
-	// Initialize semaphore with the max number of threads
-	u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
-	s32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
-	semaphore<INT32_MAX> jcores(thread_count);
+	// Object loading mutex
+	semaphore<> mutex;
 
-	if (!jcores.get())
+	ppu_jit_module_state(const ppu_module& info, const std::string& cache_path, u32 reloc, jit_module& jit_mod)
+		: info(info)
+		, cache_path(cache_path)
+		, reloc(reloc)
+		, jit_mod(jit_mod)
 	{
-		// Min value 1
-		jcores.post();
 	}
+};
 
-	// Worker threads
-	std::vector<std::thread> jthreads;
+// Module fragment to compile (or load from cache)
+struct ppu_jit_task
+{
+	ppu_jit_module_state* mod;
+	ppu_module part;
+	std::string obj_name;
 
-	// Global variables to initialize
-	std::vector<std::pair<std::string, u64>> globals;
+	// Estimated compilation cost (code size, 0 if cached)
+	std::size_t cost;
+};
 
-	// Split module into fragments <= 1 MiB
-	std::size_t fpos = 0;
+// Single progress dialog for all fragments compiled by one ppu_initialize call
+class ppu_jit_progress
+{
+	std::shared_ptr<MsgDialogBase> m_dlg;
 
-	// Difference between function name and current location
-	const u32 reloc = info.name.empty() ? 0 : info.segs.at(0).addr;
+	u32 m_total = 0;
 
-	atomic_t<u32> fragment_sync{0};
+	atomic_t<u32> m_done{0};
 
-	u32 fragment_count{0};
+public:
+	void start(u32 total)
+	{
+		m_total = total;
 
-	while (jit_mod.vars.empty() && fpos < info.funcs.size())
+		if (!total)
+		{
+			return;
+		}
+
+		m_dlg = Emu.GetCallbacks().get_msg_dialog();
+		m_dlg->type.se_normal = true;
+		m_dlg->type.bg_invisible = true;
+		m_dlg->type.progress_bar_count = 1;
+		m_dlg->on_close = [](s32 status)
+		{
+			Emu.CallAfter([]()
+			{
+				// Abort everything
+				Emu.Stop();
+			});
+		};
+
+		Emu.CallAfter([dlg = m_dlg, total]()
+		{
+			dlg->Create(fmt::format("Compiling PPU modules (0 of %u)\nPlease wait...", total));
+		});
+	}
+
+	void step(const std::string& obj_name)
+	{
+		const u32 done = ++m_done;
+
+		Emu.CallAfter([dlg = m_dlg, obj_name, done, total = m_total]()
+		{
+			dlg->SetMsg(fmt::format("Compiling PPU modules (%u of %u)\nPlease wait...", done, total));
+			dlg->ProgressBarSetMsg(0, obj_name);
+			dlg->ProgressBarInc(0, done * 100 / total - (done - 1) * 100 / total);
+		});
+	}
+};
+
+// Split module into fragments and queue them
+static void ppu_initialize_fragments(ppu_jit_module_state& mod, std::vector<ppu_jit_task>& tasks)
+{
+	const auto& info = mod.info;
+	const u32 reloc = mod.reloc;
+
+	// Split module into fragments <= 256 KiB
+	std::size_t fpos = 0;
+
+	while (mod.jit_mod.vars.empty() && fpos < info.funcs.size())
 	{
 		// Initialize compiler instance
-		if (!jit)
+		if (!mod.jit)
 		{
-			jit = std::make_shared<jit_compiler>(s_link_table, g_cfg.core.llvm_cpu);
+			mod.jit = std::make_shared<jit_compiler>(ppu_get_link_table(), g_cfg.core.llvm_cpu);
 		}
 
+		const auto& jit = mod.jit;
+
 		// First function in current module part
 		const auto fstart = fpos;
 
@@ -1300,79 +1310,34 @@ extern void ppu_initialize(const ppu_module& info)
 			fmt::append(obj_name, "-%016X-%s.obj", reinterpret_cast<be_t<u64>&>(output), jit->cpu());
 		}
 
-		if (Emu.IsStopped())
-		{
-			break;
-		}
-
-		globals.emplace_back(fmt::format("__mptr%x", suffix), (u64)vm::g_base_addr);
-		globals.emplace_back(fmt::format("__cptr%x", suffix), (u64)vm::g_exec_addr);
+		mod.globals.emplace_back(fmt::format("__mptr%x", suffix), (u64)vm::g_base_addr);
+		mod.globals.emplace_back(fmt::format("__cptr%x", suffix), (u64)vm::g_exec_addr);
 
 		// Initialize segments for relocations
 		for (u32 i = 0; i < info.segs.size(); i++)
 		{
-			globals.emplace_back(fmt::format("__seg%u_%x", i, suffix), info.segs[i].addr);
+			mod.globals.emplace_back(fmt::format("__seg%u_%x", i, suffix), info.segs[i].addr);
 		}
 
-		// Check object file
-		if (fs::is_file(cache_path + obj_name))
-		{
-			semaphore_lock lock(jmutex);
-			jit->add(cache_path + obj_name);
-
-			LOG_SUCCESS(PPU, "LLVM: Loaded module %s", obj_name);
-			continue;
-		}
+		// Object files already present only need to be loaded
+		const std::size_t cost = jit_compiler::check(mod.cache_path, obj_name) ? 0 : std::max<std::size_t>(bsize, 1);
 
-		// Create worker thread for compilation
-		jthreads.emplace_back([&jit, &jcores, obj_name = obj_name, part = std::move(part), &cache_path, &fragment_sync, findex = ::size32(jthreads)]()
-		{
-			// Set low priority
-			thread_ctrl::set_native_priority(-1);
-
-			// Allocate "core"
-			{
-				semaphore_lock jlock(jcores);
-
-				if (Emu.IsStopped())
-				{
-					return;
-				}
-
-				// Use another JIT instance
-				jit_compiler jit2({}, g_cfg.core.llvm_cpu);
-				ppu_initialize2(jit2, part, cache_path, obj_name, findex, fragment_sync);
-			}
-
-			if (Emu.IsStopped() || !fs::is_file(cache_path + obj_name))
-			{
-				return;
-			}
-
-			// Proceed with original JIT instance
-			semaphore_lock lock(jmutex);
-			jit->add(cache_path + obj_name);
-		});
-	}
-
-	// Initialize fragment count sync var
-	fragment_sync.exchange(::size32(jthreads));
-
-	// Join worker threads
-	for (auto& thread : jthreads)
-	{
-		thread.join();
+		tasks.emplace_back(ppu_jit_task{&mod, std::move(part), std::move(obj_name), cost});
 	}
+}
 
-	if (Emu.IsStopped())
-	{
-		return;
-	}
+// Install compiled functions and global variables
+static void ppu_initialize_finalize(ppu_jit_module_state& mod)
+{
+	const auto& info = mod.info;
+	const u32 reloc = mod.reloc;
+	auto& jit = mod.jit;
+	auto& jit_mod = mod.jit_mod;
 
 	// Jit can be null if the loop doesn't ever enter.
 	if (jit && jit_mod.vars.empty())
 	{
-		semaphore_lock lock(jmutex);
+		semaphore_lock lock(mod.mutex);
 		jit->fin();
 
 		// Get and install function addresses
@@ -1392,7 +1357,7 @@ extern void ppu_initialize(const ppu_module& info)
 		}
 
 		// Initialize global variables
-		for (auto& var : globals)
+		for (auto& var : mod.globals)
 		{
 			const u64 addr = jit->get(var.first);
 
@@ -1436,12 +1401,197 @@ extern void ppu_initialize(const ppu_module& info)
 			}
 		}
 	}
+}
+#endif
+
+static void ppu_initialize(const std::vector<const ppu_module*>& modules)
+{
+	if (g_cfg.core.ppu_decoder != ppu_decoder_type::llvm)
+	{
+		// Temporarily
+		s_ppu_toc = fxm::get_always<std::unordered_map<u32, u32>>().get();
+
+		for (const auto info : modules)
+		{
+			for (const auto& func : info->funcs)
+			{
+				for (auto& block : func.blocks)
+				{
+					ppu_register_function_at(block.first, block.second, nullptr);
+				}
+
+				if (g_cfg.core.ppu_debug && func.size && func.toc != -1)
+				{
+					s_ppu_toc->emplace(func.addr, func.toc);
+					ppu_ref(func.addr) = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(&ppu_check_toc));
+				}
+			}
+		}
+
+		return;
+	}
+
+#ifdef LLVM_AVAILABLE
+	// Module states (must stay at the same address)
+	std::vector<std::unique_ptr<ppu_jit_module_state>> states;
+
+	// Fragments of all modules
+	std::vector<ppu_jit_task> tasks;
+
+	for (const auto info_ptr : modules)
+	{
+		const auto& info = *info_ptr;
+
+		// Get cache path for this executable
+		std::string cache_path;
+
+		if (info.name.empty())
+		{
+			cache_path = Emu.GetCachePath();
+		}
+		else
+		{
+			cache_path = vfs::get("/dev_flash/");
+
+			if (info.path.compare(0, cache_path.size(), cache_path) == 0)
+			{
+				// Remove prefix for dev_flash files
+				cache_path.clear();
+			}
+			else
+			{
+				cache_path = Emu.GetTitleID();
+			}
+
+			cache_path = fs::get_data_dir(cache_path, info.path);
+		}
+
+		// Permanently loaded compiled PPU modules (name -> data)
+		jit_module& jit_mod = fxm::get_always<std::unordered_map<std::string, jit_module>>()->emplace(cache_path + info.name, jit_module{}).first->second;
+
+		states.emplace_back(std::make_unique<ppu_jit_module_state>(info, cache_path, info.name.empty() ? 0 : info.segs.at(0).addr, jit_mod));
+
+		ppu_initialize_fragments(*states.back(), tasks);
+
+		if (Emu.IsStopped())
+		{
+			return;
+		}
+	}
+
+	// Schedule the most expensive fragments first (cached objects go last)
+	std::stable_sort(tasks.begin(), tasks.end(), [](const ppu_jit_task& a, const ppu_jit_task& b)
+	{
+		return a.cost > b.cost;
+	});
+
+	ppu_jit_progress progress;
+	progress.start(static_cast<u32>(std::count_if(tasks.begin(), tasks.end(), [](const ppu_jit_task& t) { return t.cost != 0; })));
+
+	// Next task index (shared by all workers)
+	atomic_t<u32> task_index{0};
+
+	const auto worker = [&]()
+	{
+		for (u32 i; (i = task_index++) < tasks.size();)
+		{
+			if (Emu.IsStopped())
+			{
+				return;
+			}
+
+			auto& task = tasks[i];
+			auto& mod = *task.mod;
+
+			if (task.cost)
+			{
+				// Use another JIT instance
+				jit_compiler jit2({}, g_cfg.core.llvm_cpu);
+				ppu_initialize2(jit2, task.part, mod.cache_path, task.obj_name);
+
+				progress.step(task.obj_name);
+
+				if (Emu.IsStopped() || !jit_compiler::check(mod.cache_path, task.obj_name))
+				{
+					continue;
+				}
+			}
+
+			// Proceed with original JIT instance
+			semaphore_lock lock(mod.mutex);
+			mod.jit->add(mod.cache_path, task.obj_name);
+
+			if (!task.cost)
+			{
+				LOG_SUCCESS(PPU, "LLVM: Loaded module %s", task.obj_name);
+			}
+		}
+	};
+
+	// Initialize the number of threads
+	const u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
+	const u32 thread_count = std::max<u32>(1, max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency());
+
+	// Worker threads
+	std::vector<std::thread> jthreads;
+
+	for (u32 i = 0; i < thread_count && i < tasks.size(); i++)
+	{
+		jthreads.emplace_back([&]()
+		{
+			// Set low priority
+			thread_ctrl::set_native_priority(-1);
+
+			worker();
+		});
+	}
+
+	// Join worker threads
+	for (auto& thread : jthreads)
+	{
+		thread.join();
+	}
+
+	if (Emu.IsStopped())
+	{
+		return;
+	}
+
+	for (auto& mod : states)
+	{
+		ppu_initialize_finalize(*mod);
+	}
 #else
 	fmt::throw_exception("LLVM is not available in this build.");
 #endif
 }
 
-static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name, u32 fragment_index, atomic_t<u32>& fragment_sync)
+extern void ppu_initialize()
+{
+	const auto _main = fxm::withdraw<ppu_module>();
+
+	if (!_main)
+	{
+		return;
+	}
+
+	// Main module and preloaded libraries are compiled together
+	std::vector<const ppu_module*> modules{_main.get()};
+
+	idm::select<lv2_obj, lv2_prx>([&](u32, lv2_prx& prx)
+	{
+		modules.emplace_back(&prx);
+	});
+
+	ppu_initialize(modules);
+}
+
+extern void ppu_initialize(const ppu_module& info)
+{
+	ppu_initialize(std::vector<const ppu_module*>{&info});
+}
+
+static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name)
 {
 #ifdef LLVM_AVAILABLE
 	using namespace llvm;
@@ -1469,8 +1619,6 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 		}
 	}
 
-	std::shared_ptr<MsgDialogBase> dlg;
-
 	{
 		legacy::FunctionPassManager pm(module.get());
 
@@ -1494,25 +1642,6 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 		//pm.add(createCFGSimplificationPass());
 		//pm.add(createLintPass()); // Check
 
-		// Initialize message dialog
-		dlg = Emu.GetCallbacks().get_msg_dialog();
-		dlg->type.se_normal = true;
-		dlg->type.bg_invisible = true;
-		dlg->type.progress_bar_count = 1;
-		dlg->on_close = [](s32 status)
-		{
-			Emu.CallAfter([]()
-			{
-				// Abort everything
-				Emu.Stop();
-			});
-		};
-
-		Emu.CallAfter([=]()
-		{
-			dlg->Create("Compiling PPU module:\n" + obj_name + "\nPlease wait...");
-		});
-
 		// Translate functions
 		for (size_t fi = 0, fmax = module_part.funcs.size(); fi < fmax; fi++)
 		{
@@ -1524,18 +1653,6 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 
 			if (module_part.funcs[fi].size)
 			{
-				// Update dialog
-				Emu.CallAfter([=, max = module_part.funcs.size(), &fragment_sync]()
-				{
-					dlg->ProgressBarSetMsg(0, fmt::format("Compiling %u of %u", fi + 1, fmax));
-
-					if (fi * 100 / fmax != (fi + 1) * 100 / fmax)
-						dlg->ProgressBarInc(0, 1);
-
-					if (u32 fragment_count = fragment_sync.load())
-						dlg->SetMsg(fmt::format("Compiling PPU module (%u of %u):\n%s\nPlease wait...", fragment_index + 1, fragment_count, obj_name));
-				});
-
 				// Translate
 				if (const auto func = translator.Translate(module_part.funcs[fi]))
 				{
@@ -1558,16 +1675,6 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 		//mpm.add(createDeadInstEliminationPass());
 		//mpm.run(*module);
 
-		// Update dialog
-		Emu.CallAfter([=, &fragment_sync]()
-		{
-			dlg->ProgressBarSetMsg(0, "Generating code, this may take a long time...");
-			dlg->ProgressBarInc(0, 100);
-
-			if (u32 fragment_count = fragment_sync.load())
-				dlg->SetMsg(fmt::format("Compiling PPU module (%u of %u):\n%s\nPlease wait...", fragment_index + 1, fragment_count, obj_name));
-		});
-
 		std::string result;
 		raw_string_ostream out(result);
 
@@ -149,6 +149,14 @@ public:
 	cmd64 cmd_get(u32 index) { return cmd_queue[cmd_queue.peek() + index].load(); }
 
 	u64 start_time{0}; // Sleep start timepoint
+
+	// Scheduler run queue state (protected by the scheduler mutex)
+	ppu_thread* sched_prev{}; // Previous thread in the run queue
+	ppu_thread* sched_next{}; // Next thread in the run queue
+	u32 sched_prio{~0u}; // Run queue priority (-1 if not queued)
+	bool sched_pending{}; // Suspension requested, waiting for the thread to respond
+	atomic_t<bool> sched_queued{}; // Queued or being queued by the lock-free wake path
+	ppu_thread* sched_wake_next{}; // Next thread in the lock-free wake list
 	const char* last_function{}; // Last function name for diagnosis, optimized for speed.
 
 	const std::string m_name; // Thread name
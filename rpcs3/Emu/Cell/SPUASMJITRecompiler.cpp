@@ -53,6 +53,29 @@ void spu_recompiler::compile(spu_function_t& f)
 
 	using namespace asmjit;
 
+	typedef u32 (*Func)(void* x, void* y);
+
+	if (!f.code.empty())
+	{
+		// Reuse the code loaded from SPU database (position-independent)
+		CodeHolder code;
+		code.init(m_jit->getCodeInfo());
+
+		X86Assembler assembler(&code);
+		assembler.embed(f.code.data(), ::size32(f.code));
+
+		Func fn;
+
+		if (m_jit->add(&fn, &code) == kErrorOk)
+		{
+			f.compiled = asmjit::Internal::ptr_cast<spu_jit_func_t>(fn);
+			return;
+		}
+
+		LOG_ERROR(SPU, "Failed to load cached SPU function 0x%05x", f.addr);
+		f.code.clear();
+	}
+
 	SPUDisAsm dis_asm(CPUDisAsm_InterpreterMode);
 	dis_asm.offset = reinterpret_cast<u8*>(f.data.data()) - f.addr;
 
@@ -213,8 +236,7 @@ void spu_recompiler::compile(spu_function_t& f)
 	// Generate default function end (go to the next address)
 	compiler.bind(pos_labels[m_pos / 4 % 0x10000]);
 	compiler.comment("Fallthrough:");
-	compiler.mov(addr_var, spu_branch_target(m_pos));
-	compiler.jmp(end_label);
+	BranchFixed(spu_branch_target(m_pos));
 
 	// Generate jump table resolver (uses addr_var)
 	compiler.bind(jt_label);
@@ -249,11 +271,13 @@ void spu_recompiler::compile(spu_function_t& f)
 	compiler.finalize();
 
 	// Compile and store function address
-	typedef u32 (*Func)(void* x, void* y);
 	Func fn;
 	m_jit->add(&fn, codeHolder);
 
-	f.compiled = asmjit::Internal::ptr_cast<decltype(f.compiled)>(fn);
+	f.compiled = asmjit::Internal::ptr_cast<spu_jit_func_t>(fn);
+
+	// Keep a copy for SPU database (host calls are absolute, everything else is RIP-relative)
+	f.code.assign(reinterpret_cast<const u8*>(fn), reinterpret_cast<const u8*>(fn) + code.getCodeSize());
 
 	if (g_cfg.core.spu_debug)
 	{
@@ -306,6 +330,59 @@ inline asmjit::X86Mem spu_recompiler::XmmConst(__m128i data)
 	return XmmConst(v128::fromV(data));
 }
 
+asmjit::CCFuncCall* spu_recompiler::HostCall(void* func, const asmjit::FuncSignature& sign)
+{
+	// Direct calls would be encoded relative to the code location
+	asmjit::X86Gp fn = c->newIntPtr("fn");
+	c->mov(fn, asmjit::imm_ptr(func));
+	return c->call(fn, sign);
+}
+
+void spu_recompiler::BranchFixed(u32 target)
+{
+	// Maximal nesting level of direct calls (limits host stack usage)
+	constexpr u32 max_chain_depth = 16;
+
+	c->mov(*addr, target);
+
+	// Call the target directly if it was validated for this thread (see spu_recompiler_base::enter)
+	c->mov(*qw0, SPU_OFF_64(compiled_cache, target / 4));
+	c->test(*qw0, *qw0);
+	c->jz(*end);
+	c->mov(*qw1, SPU_OFF_64(compiled_gen, target / 4));
+	c->cmp(*qw1, SPU_OFF_64(ls_gen));
+	c->jne(*end);
+	c->cmp(asmjit::x86::byte_ptr(*qw0, offset32(&spu_function_t::does_reset_stack)), 0);
+	c->jne(*end);
+	c->mov(*qw0, asmjit::x86::qword_ptr(*qw0, offset32(&spu_function_t::compiled)));
+	c->test(*qw0, *qw0);
+	c->jz(*end);
+
+	// Interrupts and state changes are handled by the dispatcher
+	c->cmp(SPU_OFF_32(state), 0);
+	c->jne(*end);
+	c->cmp(SPU_OFF_8(interrupts_enabled), 0);
+	c->jne(*end);
+	c->cmp(SPU_OFF_32(chain_depth), max_chain_depth);
+	c->jae(*end);
+
+	c->inc(SPU_OFF_32(chain_depth));
+	c->inc(SPU_OFF_64(jit_chain_count));
+	c->mov(SPU_OFF_32(pc), target);
+
+	asmjit::CCFuncCall* call = c->call(*qw0, asmjit::FuncSignature2<u32, void*, void*>(asmjit::CallConv::kIdHost));
+	call->setArg(0, *cpu);
+	call->setArg(1, *ls);
+	call->setRet(0, *addr);
+
+	// Return the result of the target
+	c->dec(SPU_OFF_32(chain_depth));
+	c->jmp(*end);
+	c->unuse(*qw0);
+	c->unuse(*qw1);
+	c->unuse(*addr);
+}
+
 void spu_recompiler::CheckInterruptStatus(spu_opcode_t op)
 {
 	if (op.d)
@@ -361,7 +438,7 @@ void spu_recompiler::InterpreterCall(spu_opcode_t op)
 	};
 
 	c->mov(SPU_OFF_32(pc), m_pos);
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, u32(SPUThread*, u32, spu_inter_func_t)>(gate)), asmjit::FuncSignature3<u32, void*, u32, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, u32(SPUThread*, u32, spu_inter_func_t)>(gate), asmjit::FuncSignature3<u32, void*, u32, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *cpu);
 	call->setArg(1, asmjit::imm_u(op.opcode));
 	call->setArg(2, asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*>(g_spu_interpreter_fast.decode(op.opcode))));
@@ -437,7 +514,7 @@ void spu_recompiler::FunctionCall()
 		}
 	};
 
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, u32(SPUThread*, u32)>(gate)), asmjit::FuncSignature2<u32, SPUThread*, u32>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, u32(SPUThread*, u32)>(gate), asmjit::FuncSignature2<u32, SPUThread*, u32>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *cpu);
 	call->setArg(1, asmjit::imm_u(spu_branch_target(m_pos + 4)));
 	call->setRet(0, *addr);
@@ -460,6 +537,7 @@ void spu_recompiler::LNOP(spu_opcode_t op)
 void spu_recompiler::SYNC(spu_opcode_t op)
 {
 	// This instruction must be used following a store instruction that modifies the instruction stream.
+	c->lock().inc(SPU_OFF_64(ls_gen));
 	c->mfence();
 }
 
@@ -639,7 +717,7 @@ void spu_recompiler::ROT(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const s32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const s32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -694,7 +772,7 @@ void spu_recompiler::ROTM(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -749,7 +827,7 @@ void spu_recompiler::ROTMA(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(s32*, const s32*, const u32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(s32*, const s32*, const u32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -801,7 +879,7 @@ void spu_recompiler::SHL(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -856,7 +934,7 @@ void spu_recompiler::ROTH(spu_opcode_t op) //nf
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -931,7 +1009,7 @@ void spu_recompiler::ROTHM(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -1008,7 +1086,7 @@ void spu_recompiler::ROTMAH(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(s16*, const s16*, const u16*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(s16*, const s16*, const u16*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -1079,7 +1157,7 @@ void spu_recompiler::SHLH(spu_opcode_t op)
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u16*, const u16*, const u16*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -1572,7 +1650,7 @@ void spu_recompiler::ROTQBYBI(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -1603,7 +1681,7 @@ void spu_recompiler::ROTQMBYBI(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -1634,7 +1712,7 @@ void spu_recompiler::SHLQBYBI(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -1778,7 +1856,7 @@ void spu_recompiler::ROTQBY(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -1810,7 +1888,7 @@ void spu_recompiler::ROTQMBY(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -1842,7 +1920,7 @@ void spu_recompiler::SHLQBY(spu_opcode_t op)
 		c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->mov(*addr, SPU_OFF_32(gpr, op.rb, &v128::_u32, 3));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body)), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, u32)>(body), asmjit::FuncSignature3<void, void*, void*, u32>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *addr);
@@ -2160,7 +2238,7 @@ void spu_recompiler::CLZ(spu_opcode_t op)
 
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*)>(body)), asmjit::FuncSignature2<void, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*)>(body), asmjit::FuncSignature2<void, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 
@@ -2584,7 +2662,7 @@ void spu_recompiler::CGX(spu_opcode_t op) //nf
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -2604,7 +2682,7 @@ void spu_recompiler::BGX(spu_opcode_t op) //nf
 	c->lea(*qw0, SPU_OFF_128(gpr, op.rt));
 	c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 	c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
-	asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body)), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
+	asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u32*, const u32*, const u32*)>(body), asmjit::FuncSignature3<void, void*, void*, void*>(asmjit::CallConv::kIdHost));
 	call->setArg(0, *qw0);
 	call->setArg(1, *qw1);
 	call->setArg(2, *qw2);
@@ -3024,9 +3102,7 @@ void spu_recompiler::BRA(spu_opcode_t op)
 			LOG_ERROR(SPU, "Local block not registered (bra 0x%x)", target);
 		}
 
-		c->mov(*addr, target);
-		c->jmp(*end);
-		c->unuse(*addr);
+		BranchFixed(target);
 	}
 }
 
@@ -3094,9 +3170,7 @@ void spu_recompiler::BR(spu_opcode_t op)
 			LOG_ERROR(SPU, "Local block not registered (brz 0x%x)", target);
 		}
 
-		c->mov(*addr, target);
-		c->jmp(*end);
-		c->unuse(*addr);
+		BranchFixed(target);
 	}
 }
 
@@ -3559,7 +3633,7 @@ void spu_recompiler::SHUFB(spu_opcode_t op)
 		c->lea(*qw1, SPU_OFF_128(gpr, op.ra));
 		c->lea(*qw2, SPU_OFF_128(gpr, op.rb));
 		c->lea(*qw3, SPU_OFF_128(gpr, op.rc));
-		asmjit::CCFuncCall* call = c->call(asmjit::imm_ptr(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, const u8*, const u8*)>(body)), asmjit::FuncSignature4<void, void*, void*, void*, void*>(asmjit::CallConv::kIdHost));
+		asmjit::CCFuncCall* call = HostCall(asmjit::Internal::ptr_cast<void*, void(u8*, const u8*, const u8*, const u8*)>(body), asmjit::FuncSignature4<void, void*, void*, void*, void*>(asmjit::CallConv::kIdHost));
 		call->setArg(0, *qw0);
 		call->setArg(1, *qw1);
 		call->setArg(2, *qw2);
@@ -11,6 +11,8 @@ namespace asmjit
 	struct X86Xmm;
 	struct X86Mem;
 	struct Label;
+	struct FuncSignature;
+	struct CCFuncCall;
 }
 
 // SPU ASMJIT Recompiler
@@ -78,6 +80,12 @@ private:
 	asmjit::X86Mem XmmConst(__m128 data);
 	asmjit::X86Mem XmmConst(__m128i data);
 
+	// Call host function through a register (keeps the code position-independent)
+	asmjit::CCFuncCall* HostCall(void* func, const asmjit::FuncSignature& sign);
+
+	// Leave the function for a statically known address (may call the compiled target directly)
+	void BranchFixed(u32 target);
+
 public:
 	void CheckInterruptStatus(spu_opcode_t op);
 	void InterpreterCall(spu_opcode_t op);
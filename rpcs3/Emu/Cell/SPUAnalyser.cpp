@@ -1,18 +1,160 @@
 #include "stdafx.h"
+#include "Emu/System.h"
 #include "SPUAnalyser.h"
 #include "SPURecompiler.h"
 #include "SPUOpcodes.h"
+#include "Crypto/sha1.h"
+
+#include <future>
+#include <mutex>
 
 const spu_decoder<spu_itype> s_spu_itype;
 
+// SPU database file header
+struct spu_db_header
+{
+	u64 magic;
+	u32 version;
+	u32 count;
+
+	// Compiled code contains absolute addresses within the executable:
+	// it's only valid for the same executable file loaded at the same address
+	u64 build;
+	u64 anchor;
+};
+
+// SPU database file entry (followed by data, blocks, adjacent, jtable and code arrays)
+struct spu_db_entry
+{
+	u32 addr;
+	u32 size;
+	u64 hash;
+	u32 blocks;
+	u32 adjacent;
+	u32 jtable;
+	u32 code;
+	u32 does_reset_stack;
+	u32 reserved;
+	u64 checksum; // Entry (with zero checksum) and all following arrays
+};
+
+constexpr u64 s_spu_db_magic = 0x5550533353435052; // "RPCS3SPU"
+constexpr u32 s_spu_db_version = 2;
+
+// Hash of the executable file (0 if unavailable, compiled code is not stored then)
+static std::shared_future<u64> s_spu_db_build;
+static std::once_flag s_spu_db_build_once;
+
+// Start hashing the executable in background (called on Emu.Load, before SPU threads need it)
+void spu_db_prepare()
+{
+	std::call_once(s_spu_db_build_once, []
+	{
+		s_spu_db_build = std::async(std::launch::async, []() -> u64
+		{
+			const fs::file f(fs::get_executable_path());
+
+			if (!f)
+			{
+				LOG_ERROR(SPU, "SPU database: failed to read the executable, compiled code will not be cached");
+				return 0;
+			}
+
+			sha1_context ctx;
+			sha1_starts(&ctx);
+
+			std::vector<uchar> buf(0x100000);
+
+			while (const u64 size = f.read(buf.data(), buf.size()))
+			{
+				sha1_update(&ctx, buf.data(), size);
+			}
+
+			uchar output[20];
+			sha1_finish(&ctx, output);
+
+			u64 result;
+			std::memcpy(&result, output, sizeof(result));
+			return result | 1;
+		}).share();
+	});
+}
+
+static u64 spu_db_build()
+{
+	spu_db_prepare();
+	return s_spu_db_build.get();
+}
+
+static u64 spu_db_anchor()
+{
+	return reinterpret_cast<u64>(&spu_recompiler_base::enter);
+}
+
+constexpr u64 s_fnv_basis = 14695981039346656037ull;
+
+// FNV-1a 64-bit (bytes)
+static u64 spu_hash_bytes(u64 hash, const void* data, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ static_cast<const u8*>(data)[i]) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+template <typename T>
+static u64 spu_hash_vector(u64 hash, const std::vector<T>& data)
+{
+	return spu_hash_bytes(hash, data.data(), data.size() * sizeof(T));
+}
+
+// FNV-1a 64-bit (one word)
+static inline u64 spu_hash_step(u64 hash, const be_t<u32>& word)
+{
+	return (hash ^ *reinterpret_cast<const u32*>(&word)) * 1099511628211ull;
+}
+
+static u64 spu_function_hash(const be_t<u32>* data, u32 size)
+{
+	u64 result = s_fnv_basis;
+
+	for (u32 i = 0; i < size / 4; i++)
+	{
+		result = spu_hash_step(result, data[i]);
+	}
+
+	return result;
+}
+
 spu_function_t* SPUDatabase::find(const be_t<u32>* data, u64 key, u32 max_size)
 {
-	for (auto found = m_db.equal_range(key); found.first != found.second; found.first++)
+	const auto found = m_db.find(key);
+
+	if (found == m_db.end())
 	{
-		const auto& func = found.first->second;
+		return nullptr;
+	}
+
+	// Hash LS contents incrementally: candidates are sorted by size, so every word is hashed once
+	u64 hash = s_fnv_basis;
+	u32 pos = 0;
+
+	for (const auto& func : found->second)
+	{
+		if (func->size > max_size)
+		{
+			break;
+		}
+
+		for (; pos < func->size / 4; pos++)
+		{
+			hash = spu_hash_step(hash, data[pos]);
+		}
 
-		// Compare binary data explicitly (TODO: optimize)
-		if (LIKELY(func->size <= max_size) && std::memcmp(func->data.data(), data, func->size) == 0)
+		// Compare binary data explicitly only if the hash matches
+		if (hash == func->hash && std::memcmp(func->data.data(), data, func->size) == 0)
 		{
 			return func.get();
 		}
@@ -21,16 +163,211 @@ spu_function_t* SPUDatabase::find(const be_t<u32>* data, u64 key, u32 max_size)
 	return nullptr;
 }
 
-SPUDatabase::SPUDatabase()
+void SPUDatabase::insert(u64 key, std::shared_ptr<spu_function_t> func)
 {
-	// TODO: load existing database associated with currently running executable
+	auto& list = m_db[key];
+
+	const auto pos = std::upper_bound(list.begin(), list.end(), func->size, [](u32 size, const std::shared_ptr<spu_function_t>& f)
+	{
+		return size < f->size;
+	});
 
+	list.emplace(pos, std::move(func));
+}
+
+SPUDatabase::SPUDatabase()
+	: m_path(Emu.GetCachePath() + "spu.db")
+{
 	LOG_SUCCESS(SPU, "SPU Database initialized...");
 }
 
 SPUDatabase::~SPUDatabase()
 {
-	// TODO: serialize database
+	try
+	{
+		save();
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR(SPU, "Failed to save SPU database: %s", e.what());
+	}
+}
+
+void SPUDatabase::load()
+{
+	const fs::file f(m_path);
+
+	if (!f)
+	{
+		return;
+	}
+
+	spu_db_header header;
+
+	if (!f.read(header) || header.magic != s_spu_db_magic || header.version != s_spu_db_version)
+	{
+		LOG_ERROR(SPU, "SPU database ignored (invalid header): %s", m_path);
+		return;
+	}
+
+	// Compiled code is only valid for the same executable
+	const bool use_code = header.build && header.build == spu_db_build() && header.anchor == spu_db_anchor();
+
+	u32 count = 0, code_count = 0;
+
+	for (u32 i = 0; i < header.count; i++)
+	{
+		spu_db_entry entry;
+
+		if (!f.read(entry))
+		{
+			break;
+		}
+
+		if (entry.addr >= 0x40000 || entry.addr % 4 || !entry.size || entry.size % 4 || entry.size > 0x40000 - entry.addr)
+		{
+			LOG_ERROR(SPU, "SPU database truncated (invalid entry 0x%05x, size=0x%x)", entry.addr, entry.size);
+			break;
+		}
+
+		// Bound the array sizes before allocating them (the checksum is only verified afterwards)
+		const u64 remaining = f.size() - f.pos();
+
+		if (entry.blocks > 0x40000 / 4 || entry.adjacent > 0x40000 / 4 || entry.jtable > 0x40000 / 4 ||
+			u64{entry.size} + (u64{entry.blocks} + entry.adjacent + entry.jtable) * sizeof(u32) + entry.code > remaining)
+		{
+			LOG_ERROR(SPU, "SPU database truncated (invalid entry 0x%05x, blocks=%u, adjacent=%u, jtable=%u, code=0x%x)", entry.addr, entry.blocks, entry.adjacent, entry.jtable, entry.code);
+			break;
+		}
+
+		auto func = std::make_shared<spu_function_t>(entry.addr, entry.size);
+		func->data.resize(entry.size / 4);
+		func->hash = entry.hash;
+		func->does_reset_stack = entry.does_reset_stack != 0;
+
+		std::vector<u32> blocks(entry.blocks), adjacent(entry.adjacent), jtable(entry.jtable);
+		std::vector<u8> code(entry.code);
+
+		if (f.read(func->data.data(), entry.size) != entry.size || !f.read(blocks) || !f.read(adjacent) || !f.read(jtable) || !f.read(code))
+		{
+			LOG_ERROR(SPU, "SPU database truncated (entry 0x%05x)", entry.addr);
+			break;
+		}
+
+		// Validate the whole record
+		const u64 checksum = entry.checksum;
+		entry.checksum = 0;
+
+		u64 hash = spu_hash_bytes(s_fnv_basis, &entry, sizeof(entry));
+		hash = spu_hash_vector(hash, func->data);
+		hash = spu_hash_vector(hash, blocks);
+		hash = spu_hash_vector(hash, adjacent);
+		hash = spu_hash_vector(hash, jtable);
+		hash = spu_hash_vector(hash, code);
+
+		if (hash != checksum || spu_function_hash(func->data.data(), entry.size) != entry.hash)
+		{
+			LOG_ERROR(SPU, "SPU database entry corrupted (0x%05x)", entry.addr);
+			continue;
+		}
+
+		func->blocks.insert(blocks.begin(), blocks.end());
+		func->adjacent.insert(adjacent.begin(), adjacent.end());
+		func->jtable.insert(jtable.begin(), jtable.end());
+
+		if (use_code && !code.empty())
+		{
+			func->code = std::move(code);
+			code_count++;
+		}
+
+		insert(entry.addr | u64{ func->data[0] } << 32, std::move(func));
+		count++;
+	}
+
+	LOG_SUCCESS(SPU, "SPU database loaded: %u functions (%u compiled)", count, code_count);
+}
+
+void SPUDatabase::save()
+{
+	reader_lock lock(m_mutex);
+
+	if (m_db.empty())
+	{
+		return;
+	}
+
+	// Write to a temporary file first
+	fs::file f(m_path + ".tmp", fs::rewrite);
+
+	if (!f)
+	{
+		LOG_ERROR(SPU, "Failed to create SPU database: %s", m_path);
+		return;
+	}
+
+	spu_db_header header{};
+	header.magic = s_spu_db_magic;
+	header.version = s_spu_db_version;
+	header.count = 0;
+	header.build = spu_db_build();
+	header.anchor = spu_db_anchor();
+
+	for (const auto& pair : m_db)
+	{
+		header.count += ::size32(pair.second);
+	}
+
+	f.write(header);
+
+	for (const auto& pair : m_db)
+	for (const auto& ptr : pair.second)
+	{
+		const spu_function_t& func = *ptr;
+
+		const std::vector<u32> blocks(func.blocks.begin(), func.blocks.end());
+		const std::vector<u32> adjacent(func.adjacent.begin(), func.adjacent.end());
+		const std::vector<u32> jtable(func.jtable.begin(), func.jtable.end());
+
+		spu_db_entry entry{};
+		entry.addr = func.addr;
+		entry.size = func.size;
+		entry.hash = func.hash;
+		entry.blocks = ::size32(blocks);
+		entry.adjacent = ::size32(adjacent);
+		entry.jtable = ::size32(jtable);
+		entry.does_reset_stack = func.does_reset_stack;
+
+		// Don't store code which cannot be validated on load
+		const std::vector<u8> empty;
+		const auto& code = header.build ? func.code : empty;
+		entry.code = ::size32(code);
+
+		u64 hash = spu_hash_bytes(s_fnv_basis, &entry, sizeof(entry));
+		hash = spu_hash_vector(hash, func.data);
+		hash = spu_hash_vector(hash, blocks);
+		hash = spu_hash_vector(hash, adjacent);
+		hash = spu_hash_vector(hash, jtable);
+		hash = spu_hash_vector(hash, code);
+		entry.checksum = hash;
+
+		f.write(entry);
+		f.write(func.data.data(), func.size);
+		f.write(blocks);
+		f.write(adjacent);
+		f.write(jtable);
+		f.write(code);
+	}
+
+	f.close();
+
+	if (!fs::rename(m_path + ".tmp", m_path, true))
+	{
+		LOG_ERROR(SPU, "Failed to write SPU database: %s", m_path);
+		return;
+	}
+
+	LOG_NOTICE(SPU, "SPU database saved: %u functions", header.count);
 }
 
 spu_function_t* SPUDatabase::analyse(const be_t<u32>* ls, u32 entry, u32 max_limit)
@@ -46,6 +383,17 @@ spu_function_t* SPUDatabase::analyse(const be_t<u32>* ls, u32 entry, u32 max_lim
 	const be_t<u32>* base = ls + entry / 4;
 	const u32 block_sz = max_limit - entry;
 
+	if (UNLIKELY(!m_loaded))
+	{
+		writer_lock lock(m_mutex);
+
+		if (!m_loaded)
+		{
+			load();
+			m_loaded = true;
+		}
+	}
+
 	{
 		reader_lock lock(m_mutex);
 
@@ -343,13 +691,16 @@ spu_function_t* SPUDatabase::analyse(const be_t<u32>* ls, u32 entry, u32 max_lim
 	// Set whether the function can reset stack
 	func->does_reset_stack = ila_sp_pos < limit;
 
+	// Set content hash
+	func->hash = spu_function_hash(func->data.data(), func->size);
+
 	// Lock here just before we write to the db
 	// Its is unlikely that the second check will pass anyway so we delay this step since compiling functions is very fast
 	{
 		writer_lock lock(m_mutex);
 
 		// Add function to the database
-		m_db.emplace(key, func);
+		insert(key, func);
 	}
 
 	LOG_NOTICE(SPU, "Function detected [0x%05x-0x%05x] (size=0x%x)", func->addr, func->addr + func->size, func->size);
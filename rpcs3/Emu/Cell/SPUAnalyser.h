@@ -246,6 +246,9 @@ struct spu_itype
 
 class SPUThread;
 
+// Compiled SPU function type
+using spu_jit_func_t = u32(*)(SPUThread* _spu, be_t<u32>* _ls);
+
 // SPU basic function information structure
 struct spu_function_t
 {
@@ -270,8 +273,17 @@ struct spu_function_t
 	// Whether ila $SP,* instruction found
 	bool does_reset_stack;
 
-	// Pointer to the compiled function
-	u32(*compiled)(SPUThread* _spu, be_t<u32>* _ls) = nullptr;
+	// Content hash (FNV-1a over the function contents)
+	u64 hash = 0;
+
+	// Position-independent copy of the compiled function (stored in the database file)
+	std::vector<u8> code;
+
+	// Pointer to the compiled function (may be set by another thread)
+	atomic_t<spu_jit_func_t> compiled{nullptr};
+
+	// Set when the function is queued for background compilation
+	atomic_t<bool> queued{false};
 
 	spu_function_t(u32 addr, u32 size)
 		: addr(addr)
@@ -285,12 +297,27 @@ class SPUDatabase final : spu_itype
 {
 	shared_mutex m_mutex;
 
-	// All registered functions (uses addr and first instruction as a key)
-	std::unordered_multimap<u64, std::shared_ptr<spu_function_t>> m_db;
+	// All registered functions (uses addr and first instruction as a key, sorted by size)
+	std::unordered_map<u64, std::vector<std::shared_ptr<spu_function_t>>> m_db;
+
+	// Database file path (in the title's cache directory)
+	const std::string m_path;
+
+	// Set after the database file has been loaded (lazily, on first lookup)
+	atomic_t<bool> m_loaded{false};
 
 	// For internal use
 	spu_function_t* find(const be_t<u32>* data, u64 key, u32 max_size);
 
+	// Add function to the database (m_mutex must be locked)
+	void insert(u64 key, std::shared_ptr<spu_function_t> func);
+
+	// Load functions from the database file (m_mutex must be locked)
+	void load();
+
+	// Write all functions to the database file
+	void save();
+
 public:
 	SPUDatabase();
 	~SPUDatabase();
@@ -75,6 +75,8 @@ bool spu_interpreter::LNOP(SPUThread& spu, spu_opcode_t op)
 // This instruction must be used following a store instruction that modifies the instruction stream.
 bool spu_interpreter::SYNC(SPUThread& spu, spu_opcode_t op)
 {
+	// Instruction stream may have been modified
+	spu.ls_gen++;
 	_mm_mfence();
 	return true;
 }
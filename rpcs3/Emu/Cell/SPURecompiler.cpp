@@ -1,18 +1,90 @@
 #include "stdafx.h"
 #include "Emu/IdManager.h"
 #include "Emu/Memory/Memory.h"
+#include "Emu/System.h"
+#include "Utilities/Thread.h"
 
 #include "SPUThread.h"
+#include "SPUOpcodes.h"
+#include "SPUInterpreter.h"
 #include "SPURecompiler.h"
 #include "SPUASMJITRecompiler.h"
 #include <algorithm>
 
 extern u64 get_system_time();
 
+extern const spu_decoder<spu_interpreter_fast> g_spu_interpreter_fast;
+
+const spu_decoder<spu_itype> s_spu_itype;
+
+// Get mask of 4 KiB LS pages occupied by the function
+static u64 get_ls_page_mask(const spu_function_t& func)
+{
+	const u32 first = func.addr / 4096;
+	const u32 last = (func.addr + func.size - 1) / 4096;
+	return (~0ull >> (63 - last)) & (~0ull << first);
+}
+
 spu_recompiler_base::~spu_recompiler_base()
 {
 }
 
+void spu_recompiler_base::interpret(SPUThread& spu, const spu_function_t& func)
+{
+	const auto _ls = vm::_ptr<const be_t<u32>>(spu.offset);
+
+	// Execute until the function is left (like compiled function returns)
+	while (spu.pc >= func.addr && spu.pc < func.addr + func.size)
+	{
+		if (test(spu.state) && spu.check_state())
+		{
+			return;
+		}
+
+		const u32 pos = spu.pc;
+		const u32 op = _ls[pos / 4];
+
+		if (g_spu_interpreter_fast.decode(op)(spu, {op}))
+		{
+			spu.pc += 4;
+			continue;
+		}
+
+		// Branch taken (or the instruction must be repeated)
+		const auto type = s_spu_itype.decode(op);
+
+		if (spu.pc != pos && (type == spu_itype::BRSL || type == spu_itype::BRASL || type == spu_itype::BISL))
+		{
+			const u32 link = spu_branch_target(pos + 4);
+
+			if (spu.pc == link)
+			{
+				continue;
+			}
+
+			// Function call (same as in compiled code)
+			spu.recursion_level++;
+
+			while (!test(spu.state) || !spu.check_state())
+			{
+				enter(spu);
+
+				if (test(spu.state & cpu_flag::ret) || spu.pc == link)
+				{
+					break;
+				}
+			}
+
+			spu.recursion_level--;
+
+			if (spu.pc != link)
+			{
+				return;
+			}
+		}
+	}
+}
+
 void spu_recompiler_base::enter(SPUThread& spu)
 {
 	if (spu.pc >= 0x40000 || spu.pc % 4)
@@ -20,17 +92,40 @@ void spu_recompiler_base::enter(SPUThread& spu)
 		fmt::throw_exception("Invalid PC: 0x%05x", spu.pc);
 	}
 
+	spu.jit_dispatch_count++;
+
 	// Get SPU LS pointer
 	const auto _ls = vm::_ptr<u32>(spu.offset);
 
 	// Search if cached data matches
 	auto func = spu.compiled_cache[spu.pc / 4];
 
-	// Check shared db if we dont have a match
-	if (!func || !std::equal(func->data.begin(), func->data.end(), _ls + spu.pc / 4, [](const be_t<u32>& l, const be_t<u32>& r) { return *(u32*)(u8*)&l == *(u32*)(u8*)&r; }))
+	// Cached entry is valid if LS code generation is unchanged since it was checked
+	if (UNLIKELY(!func || spu.compiled_gen[spu.pc / 4] != spu.ls_gen))
 	{
-		func = spu.spu_db->analyse(_ls, spu.pc);
-		spu.compiled_cache[spu.pc / 4] = func;
+		const u64 gen = spu.ls_gen;
+
+		if (func)
+		{
+			// Register LS pages before checking the contents (LS writes to them will increment ls_gen)
+			spu.ls_code_pages |= get_ls_page_mask(*func);
+		}
+
+		// Check shared db if we dont have a match
+		if (!func || !std::equal(func->data.begin(), func->data.end(), _ls + spu.pc / 4, [](const be_t<u32>& l, const be_t<u32>& r) { return *(u32*)(u8*)&l == *(u32*)(u8*)&r; }))
+		{
+			func = spu.spu_db->analyse(_ls, spu.pc);
+			spu.compiled_cache[spu.pc / 4] = func;
+
+			// Contents are validated again on the next entry
+			spu.ls_code_pages |= get_ls_page_mask(*func);
+		}
+		else if (spu.offset < RAW_SPU_BASE_ADDR)
+		{
+			// Raw SPU LS is mapped into the PPU address space and can be written without notification,
+			// so its entries are never marked validated and their contents are compared on every entry
+			spu.compiled_gen[spu.pc / 4] = gen;
+		}
 	}
 
 	// Reset callstack if necessary
@@ -40,55 +135,155 @@ void spu_recompiler_base::enter(SPUThread& spu)
 		return;
 	}
 
-	// Compile if needed
-	if (!func->compiled)
+	if (!func->compiled && g_cfg.core.spu_compile_threads)
 	{
-		if (!spu.spu_rec)
+		// Compile in background, use the interpreter meanwhile
+		if (!func->queued.exchange(true))
 		{
-			spu.spu_rec = fxm::get_always<spu_recompiler>();
+			fxm::get_always<spu_compile_queue>()->push(spu.spu_db, *func);
 		}
 
-		spu.spu_rec->compile(*func);
-
-		if (!func->compiled) fmt::throw_exception("Compilation failed" HERE);
+		interpret(spu, *func);
 	}
+	else
+	{
+		// Compile if needed
+		if (!func->compiled)
+		{
+			if (!spu.spu_rec)
+			{
+				spu.spu_rec = fxm::get_always<spu_recompiler>();
+			}
 
-	const u32 res = func->compiled(&spu, _ls);
+			spu.spu_rec->compile(*func);
 
-	if (const auto exception = spu.pending_exception)
-	{
-		spu.pending_exception = nullptr;
-		std::rethrow_exception(exception);
+			if (!func->compiled) fmt::throw_exception("Compilation failed" HERE);
+		}
+
+		const u32 res = func->compiled.load()(&spu, _ls);
+
+		if (const auto exception = spu.pending_exception)
+		{
+			spu.pending_exception = nullptr;
+			std::rethrow_exception(exception);
+		}
+
+		if (res & 0x1000000)
+		{
+			spu.halt();
+		}
+
+		if (res & 0x2000000)
+		{
+		}
+
+		if (res & 0x4000000)
+		{
+			if (res & 0x8000000)
+			{
+				fmt::throw_exception("Invalid interrupt status set (0x%x)" HERE, res);
+			}
+
+			spu.set_interrupt_status(true);
+		}
+		else if (res & 0x8000000)
+		{
+			spu.set_interrupt_status(false);
+		}
+
+		spu.pc = res & 0x3fffc;
 	}
 
-	if (res & 0x1000000)
+	if (spu.interrupts_enabled && (spu.ch_event_mask & spu.ch_event_stat & SPU_EVENT_INTR_IMPLEMENTED) > 0)
 	{
-		spu.halt();
+		spu.interrupts_enabled = false;
+		spu.srr0 = std::exchange(spu.pc, 0);
 	}
+}
+
+struct spu_compile_queue::worker
+{
+	std::shared_ptr<thread_ctrl> thread;
+
+	// Own recompiler instance (compile() is not reentrant)
+	spu_recompiler rec;
+};
+
+spu_compile_queue::spu_compile_queue()
+{
+	const u32 count = g_cfg.core.spu_compile_threads;
 
-	if (res & 0x2000000)
+	for (u32 i = 0; i < count; i++)
 	{
+		m_workers.emplace_back(std::make_unique<worker>());
+
+		thread_ctrl::spawn(m_workers.back()->thread, fmt::format("SPU Compiler %u", i), [this, w = m_workers.back().get()]
+		{
+			run(*w);
+		});
 	}
 
-	if (res & 0x4000000)
+	LOG_SUCCESS(SPU, "SPU compile queue created (%u threads)", count);
+}
+
+spu_compile_queue::~spu_compile_queue()
+{
+	m_stop = true;
+
+	for (const auto& w : m_workers)
 	{
-		if (res & 0x8000000)
-		{
-			fmt::throw_exception("Invalid interrupt status set (0x%x)" HERE, res);
-		}
+		w->thread->notify();
+	}
 
-		spu.set_interrupt_status(true);
+	for (const auto& w : m_workers)
+	{
+		w->thread->join();
 	}
-	else if (res & 0x8000000)
+}
+
+void spu_compile_queue::push(const std::shared_ptr<SPUDatabase>& db, spu_function_t& f)
+{
 	{
-		spu.set_interrupt_status(false);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.emplace_back(db, &f);
 	}
 
-	spu.pc = res & 0x3fffc;
+	// Wake up the least recently notified worker
+	m_workers[m_next++ % m_workers.size()]->thread->notify();
+}
 
-	if (spu.interrupts_enabled && (spu.ch_event_mask & spu.ch_event_stat & SPU_EVENT_INTR_IMPLEMENTED) > 0)
+void spu_compile_queue::run(worker& w)
+{
+	// Emulator::Stop waits for all threads before destroying the queue
+	while (!m_stop && !Emu.IsStopped())
 	{
-		spu.interrupts_enabled = false;
-		spu.srr0 = std::exchange(spu.pc, 0);
+		std::pair<std::shared_ptr<SPUDatabase>, spu_function_t*> item{};
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_queue.empty())
+			{
+				item = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+		}
+
+		if (!item.second)
+		{
+			// Stop is not notified, check it periodically
+			thread_ctrl::wait_for(10000);
+			continue;
+		}
+
+		try
+		{
+			// Publishes func->compiled when done
+			w.rec.compile(*item.second);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(SPU, "Background compilation failed (0x%05x): %s", item.second->addr, e.what());
+		}
 	}
 }
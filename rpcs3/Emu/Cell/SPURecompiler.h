@@ -3,6 +3,7 @@
 #include "SPUAnalyser.h"
 
 #include <mutex>
+#include <deque>
 
 // SPU Recompiler instance base (must be global or PS3 process-local)
 class spu_recompiler_base
@@ -22,4 +23,33 @@ public:
 
 	// Run
 	static void enter(class SPUThread&);
+
+	// Run the function with the interpreter (while it's being compiled)
+	static void interpret(class SPUThread&, const spu_function_t&);
+};
+
+// SPU background compilation queue (must be global or PS3 process-local)
+class spu_compile_queue final
+{
+	struct worker;
+
+	std::mutex m_mutex;
+
+	// Pending functions (keep the database alive until compiled)
+	std::deque<std::pair<std::shared_ptr<class SPUDatabase>, spu_function_t*>> m_queue;
+
+	std::vector<std::unique_ptr<worker>> m_workers;
+
+	atomic_t<bool> m_stop{false};
+
+	atomic_t<u32> m_next{0};
+
+	void run(worker& w);
+
+public:
+	spu_compile_queue();
+	~spu_compile_queue();
+
+	// Queue the function for compilation (does nothing if it's already queued)
+	void push(const std::shared_ptr<class SPUDatabase>& db, spu_function_t& f);
 };
@@ -25,6 +25,8 @@
 
 const bool s_use_rtm = utils::has_rtm();
 
+const bool s_use_avx2 = utils::has_avx2();
+
 const bool s_use_ssse3 =
 #ifdef _MSC_VER
 	utils::has_ssse3();
@@ -312,6 +314,7 @@ std::string SPUThread::dump() const
 {
 	std::string&& ret = cpu_thread::dump();
 	ret += fmt::format("\n" "Tag mask: 0x%08x\n" "MFC entries: %u\n", +ch_tag_mask, mfc_queue.size());
+	ret += fmt::format("JIT dispatches: %llu\n" "JIT chained transitions: %llu\n", jit_dispatch_count, jit_chain_count);
 	ret += "Registers:\n=========\n";
 
 	for (uint i = 0; i<128; ++i) ret += fmt::format("GPR[%d] = %s\n", i, gpr[i]);
@@ -362,6 +365,9 @@ void SPUThread::cpu_init()
 	int_ctrl[2].clear();
 
 	gpr[1]._u32[3] = 0x3FFF0; // initial stack frame pointer
+
+	// LS contents are (re)loaded before start
+	ls_gen++;
 }
 
 extern thread_local std::string(*g_tls_log_prefix)();
@@ -501,6 +507,135 @@ void SPUThread::push_snr(u32 number, u32 value)
 	}
 }
 
+void SPUThread::notify_ls_write(u32 lsa, u32 size)
+{
+	if (!size)
+	{
+		return;
+	}
+
+	// Get mask of affected LS pages (4 KiB)
+	const u32 first = (lsa & 0x3ffff) / 4096;
+	const u32 count = std::min<u32>((lsa % 4096 + size + 4095) / 4096, 64);
+	const u64 mask = count >= 64 ? ~0ull : rol64((1ull << count) - 1, first);
+
+	// Pairs with setting ls_code_pages in spu_recompiler_base::enter
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (ls_code_pages & mask)
+	{
+		ls_gen++;
+	}
+}
+
+static void spu_dma_copy(__m128i* vdst, const __m128i* vsrc, u32 vcnt)
+{
+	while (vcnt >= 8)
+	{
+		const __m128i data[]
+		{
+			_mm_load_si128(vsrc + 0),
+			_mm_load_si128(vsrc + 1),
+			_mm_load_si128(vsrc + 2),
+			_mm_load_si128(vsrc + 3),
+			_mm_load_si128(vsrc + 4),
+			_mm_load_si128(vsrc + 5),
+			_mm_load_si128(vsrc + 6),
+			_mm_load_si128(vsrc + 7),
+		};
+
+		_mm_store_si128(vdst + 0, data[0]);
+		_mm_store_si128(vdst + 1, data[1]);
+		_mm_store_si128(vdst + 2, data[2]);
+		_mm_store_si128(vdst + 3, data[3]);
+		_mm_store_si128(vdst + 4, data[4]);
+		_mm_store_si128(vdst + 5, data[5]);
+		_mm_store_si128(vdst + 6, data[6]);
+		_mm_store_si128(vdst + 7, data[7]);
+
+		vcnt -= 8;
+		vsrc += 8;
+		vdst += 8;
+	}
+
+	while (vcnt--)
+	{
+		_mm_store_si128(vdst++, _mm_load_si128(vsrc++));
+	}
+}
+
+static void spu_dma_copy_stream(__m128i* vdst, const __m128i* vsrc, u32 vcnt)
+{
+	while (vcnt >= 8)
+	{
+		const __m128i data[]
+		{
+			_mm_load_si128(vsrc + 0),
+			_mm_load_si128(vsrc + 1),
+			_mm_load_si128(vsrc + 2),
+			_mm_load_si128(vsrc + 3),
+			_mm_load_si128(vsrc + 4),
+			_mm_load_si128(vsrc + 5),
+			_mm_load_si128(vsrc + 6),
+			_mm_load_si128(vsrc + 7),
+		};
+
+		_mm_stream_si128(vdst + 0, data[0]);
+		_mm_stream_si128(vdst + 1, data[1]);
+		_mm_stream_si128(vdst + 2, data[2]);
+		_mm_stream_si128(vdst + 3, data[3]);
+		_mm_stream_si128(vdst + 4, data[4]);
+		_mm_stream_si128(vdst + 5, data[5]);
+		_mm_stream_si128(vdst + 6, data[6]);
+		_mm_stream_si128(vdst + 7, data[7]);
+
+		vcnt -= 8;
+		vsrc += 8;
+		vdst += 8;
+	}
+
+	while (vcnt--)
+	{
+		_mm_stream_si128(vdst++, _mm_load_si128(vsrc++));
+	}
+
+	// Make non-temporal stores visible before the command completes
+	_mm_sfence();
+}
+
+AVX2_FUNC static void spu_dma_copy_avx2(u8* dst, const u8* src, u32 size)
+{
+	// Only 16-byte alignment is guaranteed
+	while (size >= 128)
+	{
+		const __m256i data[]
+		{
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 0)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96)),
+		};
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 0), data[0]);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), data[1]);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 64), data[2]);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 96), data[3]);
+
+		size -= 128;
+		src += 128;
+		dst += 128;
+	}
+
+	while (size >= 16)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst), _mm_load_si128(reinterpret_cast<const __m128i*>(src)));
+
+		size -= 16;
+		src += 16;
+		dst += 16;
+	}
+}
+
 void SPUThread::do_dma_transfer(const spu_mfc_cmd& args, bool from_mfc)
 {
 	const bool is_get = (args.cmd & ~(MFC_BARRIER_MASK | MFC_FENCE_MASK)) == MFC_GET_CMD;
@@ -508,6 +643,9 @@ void SPUThread::do_dma_transfer(const spu_mfc_cmd& args, bool from_mfc)
 	u32 eal = args.eal;
 	u32 lsa = args.lsa & 0x3ffff;
 
+	// Another SPU thread's LS (written by PUT)
+	SPUThread* ls_target = nullptr;
+
 	if (eal >= SYS_SPU_THREAD_BASE_LOW && offset < RAW_SPU_BASE_ADDR) // SPU Thread Group MMIO (LS and SNR)
 	{
 		const u32 index = (eal - SYS_SPU_THREAD_BASE_LOW) / SYS_SPU_THREAD_OFFSET; // thread number in group
@@ -520,6 +658,7 @@ void SPUThread::do_dma_transfer(const spu_mfc_cmd& args, bool from_mfc)
 			if (offset + args.size - 1 < 0x40000) // LS access
 			{
 				eal = spu.offset + offset; // redirect access
+				ls_target = &spu;
 			}
 			else if (!is_get && args.size == 4 && (offset == SYS_SPU_THREAD_SNR1 || offset == SYS_SPU_THREAD_SNR2))
 			{
@@ -583,90 +722,72 @@ void SPUThread::do_dma_transfer(const spu_mfc_cmd& args, bool from_mfc)
 	}
 	default:
 	{
-		auto vdst = static_cast<__m128i*>(dst);
-		auto vsrc = static_cast<const __m128i*>(src);
-		auto vcnt = size / sizeof(__m128i);
+		const u32 stream_threshold = g_cfg.core.spu_dma_stream_threshold;
 
-		//if (is_get && !from_mfc)
+		if (!is_get && stream_threshold && size >= stream_threshold)
 		{
-			while (vcnt >= 8)
-			{
-				const __m128i data[]
-				{
-					_mm_load_si128(vsrc + 0),
-					_mm_load_si128(vsrc + 1),
-					_mm_load_si128(vsrc + 2),
-					_mm_load_si128(vsrc + 3),
-					_mm_load_si128(vsrc + 4),
-					_mm_load_si128(vsrc + 5),
-					_mm_load_si128(vsrc + 6),
-					_mm_load_si128(vsrc + 7),
-				};
-
-				_mm_store_si128(vdst + 0, data[0]);
-				_mm_store_si128(vdst + 1, data[1]);
-				_mm_store_si128(vdst + 2, data[2]);
-				_mm_store_si128(vdst + 3, data[3]);
-				_mm_store_si128(vdst + 4, data[4]);
-				_mm_store_si128(vdst + 5, data[5]);
-				_mm_store_si128(vdst + 6, data[6]);
-				_mm_store_si128(vdst + 7, data[7]);
-
-				vcnt -= 8;
-				vsrc += 8;
-				vdst += 8;
-			}
-
-			while (vcnt--)
-			{
-				_mm_store_si128(vdst++, _mm_load_si128(vsrc++));
-			}
-
-			break;
+			// Large PUT: bypass the cache, the data is unlikely to be read by the SPU soon
+			spu_dma_copy_stream(static_cast<__m128i*>(dst), static_cast<const __m128i*>(src), size / sizeof(__m128i));
 		}
-
-		// Disabled
-		while (vcnt >= 8)
+		else if (s_use_avx2 && size >= 256)
 		{
-			const __m128i data[]
-			{
-				_mm_load_si128(vsrc + 0),
-				_mm_load_si128(vsrc + 1),
-				_mm_load_si128(vsrc + 2),
-				_mm_load_si128(vsrc + 3),
-				_mm_load_si128(vsrc + 4),
-				_mm_load_si128(vsrc + 5),
-				_mm_load_si128(vsrc + 6),
-				_mm_load_si128(vsrc + 7),
-			};
-
-			_mm_stream_si128(vdst + 0, data[0]);
-			_mm_stream_si128(vdst + 1, data[1]);
-			_mm_stream_si128(vdst + 2, data[2]);
-			_mm_stream_si128(vdst + 3, data[3]);
-			_mm_stream_si128(vdst + 4, data[4]);
-			_mm_stream_si128(vdst + 5, data[5]);
-			_mm_stream_si128(vdst + 6, data[6]);
-			_mm_stream_si128(vdst + 7, data[7]);
-
-			vcnt -= 8;
-			vsrc += 8;
-			vdst += 8;
+			spu_dma_copy_avx2(static_cast<u8*>(dst), static_cast<const u8*>(src), size);
 		}
-
-		while (vcnt--)
+		else
 		{
-			_mm_stream_si128(vdst++, _mm_load_si128(vsrc++));
+			spu_dma_copy(static_cast<__m128i*>(dst), static_cast<const __m128i*>(src), size / sizeof(__m128i));
 		}
 	}
 	}
 
+	if (is_get)
+	{
+		notify_ls_write(lsa, args.size);
+	}
+	else if (ls_target)
+	{
+		ls_target->notify_ls_write(eal - ls_target->offset, args.size);
+	}
+	else
+	{
+		// Wake threads waiting on the reservation
+		vm::notify(eal, args.size);
+	}
+
 	if (is_get && from_mfc)
 	{
 		//_mm_sfence();
 	}
 }
 
+void SPUThread::push_dma_batch(spu_mfc_cmd& batch, const spu_mfc_cmd& transfer)
+{
+	// Merge list elements contiguous both in LS and in main memory (MMIO must be processed separately)
+	// Both sizes must be multiples of 16: the merged transfer is copied by whole vectors only
+	if (batch.size && batch.size % 16 == 0 && transfer.size % 16 == 0 && g_cfg.core.spu_dma_batching &&
+		batch.eal + batch.size == transfer.eal &&
+		transfer.eal + transfer.size <= SYS_SPU_THREAD_BASE_LOW &&
+		(batch.lsa & 0x3ffff) + batch.size == (transfer.lsa & 0x3ffff) &&
+		(batch.lsa & 0x3ffff) + batch.size + transfer.size <= 0x40000 &&
+		batch.size + transfer.size <= UINT16_MAX)
+	{
+		batch.size += transfer.size;
+		return;
+	}
+
+	flush_dma_batch(batch);
+	batch = transfer;
+}
+
+void SPUThread::flush_dma_batch(spu_mfc_cmd& batch)
+{
+	if (batch.size)
+	{
+		do_dma_transfer(batch);
+		batch.size = 0;
+	}
+}
+
 void SPUThread::process_mfc_cmd()
 {
 	spu::scheduler::concurrent_execution_watchdog watchdog(*this);
@@ -705,7 +826,8 @@ void SPUThread::process_mfc_cmd()
 			ch_event_stat |= SPU_EVENT_LR;
 		}
 
-		const bool is_polling = false;// raddr == _addr && rtime == _time; // TODO
+		// Repeated GETLLAR on an unchanged line
+		const bool is_polling = g_cfg.core.spu_reservation_wait && raddr == _addr && rtime == _time && rdata == data;
 
 		_mm_lfence();
 		raddr = _addr;
@@ -721,9 +843,10 @@ void SPUThread::process_mfc_cmd()
 			waiter.data  = rdata.data();
 			waiter.init();
 
-			while (vm::reservation_acquire(raddr, 128) == waiter.stamp && rdata == data)
+			// Park until the line is written (woken by vm::notify), limited to let the SPU observe the decrementer
+			for (u32 i = 0; vm::reservation_acquire(raddr, 128) == waiter.stamp && rdata == data; i++)
 			{
-				if (test(state, cpu_flag::stop))
+				if (test(state, cpu_flag::stop) || i >= 10)
 				{
 					break;
 				}
@@ -733,7 +856,7 @@ void SPUThread::process_mfc_cmd()
 		}
 		else if (s_use_rtm && utils::transaction_enter())
 		{
-			if (!vm::reader_lock{vm::try_to_lock})
+			if (!vm::reader_lock{vm::try_to_lock} || !vm::reservation_lock{raddr, vm::try_to_lock})
 			{
 				_xabort(0);
 			}
@@ -743,25 +866,30 @@ void SPUThread::process_mfc_cmd()
 			_xend();
 
 			_ref<decltype(rdata)>(ch_mfc_cmd.lsa & 0x3ffff) = rdata;
+			notify_ls_write(ch_mfc_cmd.lsa, 128);
 			return ch_atomic_stat.set_value(MFC_GETLLAR_SUCCESS);
 		}
 		else
 		{
+			// Odd stamp means that the line is being written
+			rtime = vm::reservation_acquire(raddr, 128);
+			_mm_lfence();
 			rdata = data;
 			_mm_lfence();
 		}
 
 		// Hack: ensure no other atomic updates have happened during reading the data
-		if (is_polling || UNLIKELY(vm::reservation_acquire(raddr, 128) != rtime))
+		if (is_polling || UNLIKELY(rtime & 1 || vm::reservation_acquire(raddr, 128) != rtime))
 		{
 			// TODO: vm::check_addr
-			vm::reader_lock lock;
+			vm::reservation_lock lock(raddr, false);
 			rtime = vm::reservation_acquire(raddr, 128);
 			rdata = data;
 		}
 
 		// Copy to LS
 		_ref<decltype(rdata)>(ch_mfc_cmd.lsa & 0x3ffff) = rdata;
+		notify_ls_write(ch_mfc_cmd.lsa, 128);
 
 		return ch_atomic_stat.set_value(MFC_GETLLAR_SUCCESS);
 	}
@@ -779,7 +907,7 @@ void SPUThread::process_mfc_cmd()
 			// TODO: vm::check_addr
 			if (s_use_rtm && utils::transaction_enter())
 			{
-				if (!vm::reader_lock{vm::try_to_lock})
+				if (!vm::reader_lock{vm::try_to_lock} || !vm::reservation_lock{raddr, vm::try_to_lock})
 				{
 					_xabort(0);
 				}
@@ -790,22 +918,56 @@ void SPUThread::process_mfc_cmd()
 					result = true;
 
 					vm::reservation_update(raddr, 128);
-					vm::notify(raddr, 128);
 				}
 
 				_xend();
+
+				if (result)
+				{
+					vm::notify(raddr, 128);
+				}
 			}
 			else
 			{
-				vm::writer_lock lock;
+				vm::reservation_lock lock(raddr);
 
 				if (rtime == vm::reservation_acquire(raddr, 128) && rdata == data)
 				{
-					data = to_write;
-					result = true;
+					vm::reservation_lock_stamp(raddr, 128);
+
+					// Plain stores to the line are not stopped: copy in 16-byte atomic steps, each one checking the expected data
+					u32 i = 0;
+
+					for (; i < data.size(); i++)
+					{
+						u128 old = rdata[i];
+
+						if (!atomic_storage<u128>::compare_exchange(data[i], old, to_write[i]))
+						{
+							break;
+						}
+					}
+
+					if (i == data.size())
+					{
+						result = true;
+					}
+					else
+					{
+						// A plain store hit the line: undo the copy, keeping data which has been stored again since then
+						while (i--)
+						{
+							u128 old = to_write[i];
+							atomic_storage<u128>::compare_exchange(data[i], old, rdata[i]);
+						}
+					}
 
 					vm::reservation_update(raddr, 128);
-					vm::notify(raddr, 128);
+
+					if (result)
+					{
+						vm::notify(raddr, 128);
+					}
 				}
 			}
 		}
@@ -845,21 +1007,23 @@ void SPUThread::process_mfc_cmd()
 
 		if (s_use_rtm && utils::transaction_enter())
 		{
-			if (!vm::reader_lock{vm::try_to_lock})
+			if (!vm::reader_lock{vm::try_to_lock} || !vm::reservation_lock{ch_mfc_cmd.eal, vm::try_to_lock})
 			{
 				_xabort(0);
 			}
 
 			data = to_write;
 			vm::reservation_update(ch_mfc_cmd.eal, 128);
-			vm::notify(ch_mfc_cmd.eal, 128);
 			_xend();
 
+			vm::notify(ch_mfc_cmd.eal, 128);
+
 			ch_atomic_stat.set_value(MFC_PUTLLUC_SUCCESS);
 			return;
 		}
 
-		vm::writer_lock lock(0);
+		vm::reservation_lock lock(ch_mfc_cmd.eal);
+		vm::reservation_lock_stamp(ch_mfc_cmd.eal, 128);
 		data = to_write;
 		vm::reservation_update(ch_mfc_cmd.eal, 128);
 		vm::notify(ch_mfc_cmd.eal, 128);
@@ -939,6 +1103,9 @@ void SPUThread::process_mfc_cmd()
 
 			u32 total_size = 0;
 
+			// Pending merged transfer
+			spu_mfc_cmd batch{};
+
 			while (ch_mfc_cmd.size && total_size <= max_imm_dma_size)
 			{
 				ch_mfc_cmd.lsa &= 0x3fff0;
@@ -974,7 +1141,7 @@ void SPUThread::process_mfc_cmd()
 					transfer.cmd = MFC(ch_mfc_cmd.cmd & ~MFC_LIST_MASK);
 					transfer.size = size;
 
-					do_dma_transfer(transfer);
+					push_dma_batch(batch, transfer);
 					const u32 add_size = std::max<u32>(size, 16);
 					ch_mfc_cmd.lsa += add_size;
 					total_size += add_size;
@@ -984,6 +1151,8 @@ void SPUThread::process_mfc_cmd()
 				ch_mfc_cmd.size -= 8;
 			}
 
+			flush_dma_batch(batch);
+
 			if (ch_mfc_cmd.size == 0)
 			{
 				return;
@@ -586,12 +586,21 @@ public:
 	std::exception_ptr pending_exception;
 
 	std::array<struct spu_function_t*, 65536> compiled_cache{};
+	std::array<u64, 65536> compiled_gen{}; // ls_gen value at which compiled_cache entry was validated
+	atomic_t<u64> ls_gen{1}; // LS code generation, incremented when LS code may have been modified
+	atomic_t<u64> ls_code_pages{0}; // Mask of 4 KiB LS pages containing functions from compiled_cache
 	std::shared_ptr<class SPUDatabase> spu_db;
 	std::shared_ptr<class spu_recompiler_base> spu_rec;
 	u32 recursion_level = 0;
+	u32 chain_depth = 0; // Nesting level of direct calls between compiled functions
+	u64 jit_dispatch_count = 0; // Number of spu_recompiler_base::enter calls
+	u64 jit_chain_count = 0; // Number of direct transitions between compiled functions
 
 	void push_snr(u32 number, u32 value);
+	void notify_ls_write(u32 lsa, u32 size);
 	void do_dma_transfer(const spu_mfc_cmd& args, bool from_mfc = true);
+	void push_dma_batch(spu_mfc_cmd& batch, const spu_mfc_cmd& transfer);
+	void flush_dma_batch(spu_mfc_cmd& batch);
 
 	void process_mfc_cmd();
 	u32 get_events(bool waiting = false);
@@ -992,17 +992,256 @@ extern u64 get_system_time();
 DECLARE(lv2_obj::g_mutex);
 DECLARE(lv2_obj::g_ppu);
 DECLARE(lv2_obj::g_pending);
-DECLARE(lv2_obj::g_waiting);
+DECLARE(lv2_obj::g_run_state){0};
+DECLARE(lv2_obj::g_wake_list){nullptr};
+
+void lv2_obj::run_queue::push(ppu_thread& thread)
+{
+	const u32 prio = std::min<u32>(thread.prio, prio_count - 1);
+
+	thread.sched_prio = prio;
+	thread.sched_prev = tail[prio];
+	thread.sched_next = nullptr;
+	thread.sched_queued = true;
+	count++;
+
+	if (tail[prio])
+	{
+		tail[prio]->sched_next = &thread;
+	}
+	else
+	{
+		head[prio] = &thread;
+		mask[prio / 64] |= 1ull << (prio % 64);
+		summary |= 1ull << (prio / 64);
+	}
+
+	tail[prio] = &thread;
+}
+
+bool lv2_obj::run_queue::remove(ppu_thread& thread)
+{
+	const u32 prio = thread.sched_prio;
+
+	if (prio == -1)
+	{
+		return false;
+	}
+
+	if (thread.sched_prev)
+	{
+		thread.sched_prev->sched_next = thread.sched_next;
+	}
+	else
+	{
+		head[prio] = thread.sched_next;
+	}
+
+	if (thread.sched_next)
+	{
+		thread.sched_next->sched_prev = thread.sched_prev;
+	}
+	else
+	{
+		tail[prio] = thread.sched_prev;
+	}
+
+	if (!head[prio] && !(mask[prio / 64] &= ~(1ull << (prio % 64))))
+	{
+		summary &= ~(1ull << (prio / 64));
+	}
+
+	thread.sched_prio = -1;
+	thread.sched_prev = nullptr;
+	thread.sched_next = nullptr;
+	thread.sched_queued = false;
+	count--;
+	return true;
+}
+
+ppu_thread* lv2_obj::run_queue::first() const
+{
+	if (!summary)
+	{
+		return nullptr;
+	}
+
+	const u32 word = static_cast<u32>(::cnttz64(summary, true));
+	return head[word * 64 + ::cnttz64(mask[word], true)];
+}
+
+ppu_thread* lv2_obj::run_queue::next(const ppu_thread& thread) const
+{
+	if (thread.sched_next)
+	{
+		return thread.sched_next;
+	}
+
+	// Find the next non-empty list with lower priority
+	const u32 prio = thread.sched_prio;
+
+	if (const u64 bits = mask[prio / 64] & ~((2ull << (prio % 64)) - 1))
+	{
+		return head[prio / 64 * 64 + ::cnttz64(bits, true)];
+	}
+
+	if (const u64 words = summary & ~((2ull << (prio / 64)) - 1))
+	{
+		const u32 word = static_cast<u32>(::cnttz64(words, true));
+		return head[word * 64 + ::cnttz64(mask[word], true)];
+	}
+
+	return nullptr;
+}
+
+void lv2_obj::run_queue::clear()
+{
+	for (u32 prio = 0; prio < prio_count; prio++)
+	{
+		for (auto thread = head[prio]; thread;)
+		{
+			const auto next = thread->sched_next;
+			thread->sched_prio = -1;
+			thread->sched_prev = nullptr;
+			thread->sched_next = nullptr;
+			thread->sched_pending = false;
+			thread->sched_queued = false;
+			thread = next;
+		}
+	}
+
+	head.fill(nullptr);
+	tail.fill(nullptr);
+	mask.fill(0);
+	summary = 0;
+	count = 0;
+}
+
+lv2_obj::sched_lock::sched_lock()
+	: m_lock(g_mutex)
+{
+	// Stop the lock-free wake path and wait for the threads being inserted
+	g_run_state |= run_closed;
+
+	while (g_run_state & run_inflight_mask)
+	{
+		busy_wait();
+	}
+
+	// Insert awakened threads in the order of awakening
+	ppu_thread* list = nullptr;
+
+	for (auto ppu = g_wake_list.exchange(nullptr); ppu;)
+	{
+		const auto next = ppu->sched_wake_next;
+		ppu->sched_wake_next = list;
+		list = ppu;
+		ppu = next;
+	}
+
+	while (list)
+	{
+		const auto next = list->sched_wake_next;
+		list->sched_wake_next = nullptr;
+		g_ppu.push(*list);
+		list = next;
+	}
+}
+
+lv2_obj::sched_lock::~sched_lock()
+{
+	// Reopen the lock-free wake path if no thread is waiting for suspension
+	g_run_state = g_ppu.count | (g_pending ? +run_closed : 0);
+}
+
+bool lv2_obj::try_awake(ppu_thread& ppu)
+{
+	const u32 max_threads = g_cfg.core.ppu_threads;
+
+	// Take a free running slot: possible only if every queued thread is running
+	if (!g_run_state.atomic_op([&](u32& state)
+	{
+		if (state & run_closed || (state & run_count_mask) >= max_threads)
+		{
+			return false;
+		}
+
+		state += 1 + run_inflight;
+		return true;
+	}))
+	{
+		return false;
+	}
+
+	if (ppu.sched_queued.exchange(true))
+	{
+		// Already queued (or being awakened), use the locked path
+		g_run_state -= 1 + run_inflight;
+		return false;
+	}
+
+	LOG_TRACE(PPU, "awake(): %s (lock-free)", ppu.id);
+
+	// Unregister timeout before resuming: the thread may register a new one as soon as it runs
+	if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+	{
+		wheel->cancel(ppu.get());
+	}
+
+	// Resume the thread before it becomes visible to the locked path (see schedule_all)
+	const bool resume = test(ppu.state, cpu_flag::suspend);
+
+	if (resume)
+	{
+		ppu.state ^= (cpu_flag::signal + cpu_flag::suspend);
+		ppu.start_time = 0;
+	}
+
+	ppu.sched_wake_next = g_wake_list;
+
+	while (!g_wake_list.compare_and_swap_test(ppu.sched_wake_next, &ppu))
+	{
+		ppu.sched_wake_next = g_wake_list;
+	}
+
+	g_run_state -= run_inflight;
+
+	if (resume && ppu.get() != thread_ctrl::get_current())
+	{
+		ppu.notify();
+	}
+
+	return true;
+}
+
+void lv2_obj::suspend(ppu_thread& thread)
+{
+	if (!thread.state.test_and_set(cpu_flag::suspend))
+	{
+		LOG_TRACE(PPU, "suspend(): %s", thread.id);
+		thread.sched_pending = true;
+		g_pending++;
+	}
+}
+
+void lv2_obj::unqueue_pending(ppu_thread& thread)
+{
+	if (thread.sched_pending)
+	{
+		thread.sched_pending = false;
+		g_pending--;
+	}
+}
 
 void lv2_obj::sleep_timeout(named_thread& thread, u64 timeout)
 {
-	semaphore_lock lock(g_mutex);
+	sched_lock lock;
 
 	const u64 start_time = get_system_time();
 
 	if (auto ppu = dynamic_cast<ppu_thread*>(&thread))
 	{
-		LOG_TRACE(PPU, "sleep() - waiting (%zu)", g_pending.size());
+		LOG_TRACE(PPU, "sleep() - waiting (%u)", g_pending);
 
 		auto state = ppu->state.fetch_op([&](auto& val)
 		{
@@ -1018,28 +1257,19 @@ void lv2_obj::sleep_timeout(named_thread& thread, u64 timeout)
 			return;
 		}
 
-		// Find and remove the thread
-		unqueue(g_ppu, ppu);
-		unqueue(g_pending, ppu);
+		// Remove the thread
+		g_ppu.remove(*ppu);
+		unqueue_pending(*ppu);
 
 		ppu->start_time = start_time;
 	}
 
 	if (timeout)
 	{
-		const u64 wait_until = start_time + timeout;
-
-		// Register timeout if necessary
-		for (auto it = g_waiting.begin(), end = g_waiting.end(); it != end; it++)
-		{
-			if (it->first > wait_until)
-			{
-				g_waiting.emplace(it, wait_until, &thread);
-				return;
-			}
-		}
+		const u64 wait_until = start_time + std::min<u64>(timeout, ~start_time);
 
-		g_waiting.emplace_back(wait_until, &thread);
+		// Register timeout
+		fxm::check_unlocked<lv2_timer_thread>()->notify_at(thread.get(), wait_until);
 	}
 
 	schedule_all();
@@ -1050,104 +1280,123 @@ void lv2_obj::awake(cpu_thread& cpu, u32 prio)
 	// Check thread type
 	if (cpu.id_type() != 1) return;
 
-	semaphore_lock lock(g_mutex);
+	auto& ppu = static_cast<ppu_thread&>(cpu);
+
+	// Plain wake up of a thread which is not queued
+	if (prio == -1 && try_awake(ppu))
+	{
+		return;
+	}
+
+	sched_lock lock;
 
 	if (prio == -4)
 	{
 		// Yield command
 		const u64 start_time = get_system_time();
 
-		for (std::size_t i = 0, pos = -1; i < g_ppu.size(); i++)
+		if (ppu.sched_prio != -1 && !ppu.sched_next && g_ppu.next(ppu))
 		{
-			if (g_ppu[i] == &cpu)
-			{
-				pos = i;
-				prio = g_ppu[i]->prio;
-			}
-			else if (i == pos + 1 && prio != -4 && g_ppu[i]->prio != prio)
-			{
-				return;
-			}
+			// The next thread has different priority
+			return;
 		}
 
-		unqueue(g_ppu, &cpu);
-		unqueue(g_pending, &cpu);
+		// Move the thread to the end of its priority list
+		g_ppu.remove(ppu);
+		unqueue_pending(ppu);
 
-		static_cast<ppu_thread&>(cpu).start_time = start_time;
+		ppu.start_time = start_time;
 	}
-
-	if (prio < INT32_MAX && !unqueue(g_ppu, &cpu))
+	else if (prio < INT32_MAX && !g_ppu.remove(ppu))
 	{
 		// Priority set
 		return;
 	}
 
 	// Emplace current thread
-	for (std::size_t i = 0; i <= g_ppu.size(); i++)
+	if (ppu.sched_prio != -1)
+	{
+		LOG_TRACE(PPU, "sleep() - suspended (p=%u)", g_pending);
+	}
+	else
 	{
-		if (i < g_ppu.size() && g_ppu[i] == &cpu)
-		{
-			LOG_TRACE(PPU, "sleep() - suspended (p=%zu)", g_pending.size());
-			break;
-		}
-
 		// Use priority, also preserve FIFO order
-		if (i == g_ppu.size() || g_ppu[i]->prio > static_cast<ppu_thread&>(cpu).prio)
-		{
-			LOG_TRACE(PPU, "awake(): %s", cpu.id);
-			g_ppu.insert(g_ppu.cbegin() + i, &static_cast<ppu_thread&>(cpu));
+		LOG_TRACE(PPU, "awake(): %s", cpu.id);
+		g_ppu.push(ppu);
 
-			// Unregister timeout if necessary
-			for (auto it = g_waiting.cbegin(), end = g_waiting.cend(); it != end; it++)
-			{
-				if (it->second == &cpu)
-				{
-					g_waiting.erase(it);
-					break;
-				}
-			}
-
-			break;
+		// Unregister timeout if necessary
+		if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+		{
+			wheel->cancel(cpu.get());
 		}
 	}
 
 	// Remove pending if necessary
-	if (!g_pending.empty() && cpu.get() == thread_ctrl::get_current())
+	if (g_pending && cpu.get() == thread_ctrl::get_current())
 	{
-		unqueue(g_pending, &cpu);
+		unqueue_pending(ppu);
 	}
 
 	// Suspend threads if necessary
-	for (std::size_t i = g_cfg.core.ppu_threads; i < g_ppu.size(); i++)
+	// Only the first ppu_threads threads may run, and every thread beyond them is already suspended
+	// except the emplaced thread and the one it has displaced
+	bool is_running_slot = false;
+	auto target = g_ppu.first();
+
+	for (u32 i = 0; target && i < g_cfg.core.ppu_threads; i++, target = g_ppu.next(*target))
 	{
-		const auto target = g_ppu[i];
+		is_running_slot |= target == &ppu;
+	}
 
-		if (!target->state.test_and_set(cpu_flag::suspend))
-		{
-			LOG_TRACE(PPU, "suspend(): %s", target->id);
-			g_pending.emplace_back(target);
-		}
+	if (target)
+	{
+		suspend(*target);
+	}
+
+	if (!is_running_slot && ppu.sched_prio != -1)
+	{
+		suspend(ppu);
 	}
 
 	schedule_all();
 }
 
+void lv2_obj::init()
+{
+	// Syscalls access it with fxm::check_unlocked, often under idm lock
+	fxm::make_always<lv2_timer_thread>();
+}
+
 void lv2_obj::cleanup()
 {
 	g_ppu.clear();
-	g_pending.clear();
-	g_waiting.clear();
+	g_pending = 0;
+
+	for (auto ppu = g_wake_list.exchange(nullptr); ppu;)
+	{
+		const auto next = ppu->sched_wake_next;
+		ppu->sched_wake_next = nullptr;
+		ppu->sched_queued = false;
+		ppu = next;
+	}
+
+	g_run_state = 0;
+
+	if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+	{
+		wheel->clear();
+	}
 }
 
 void lv2_obj::schedule_all()
 {
-	if (g_pending.empty())
+	if (!g_pending)
 	{
 		// Wake up threads
-		for (std::size_t i = 0, x = std::min<std::size_t>(g_cfg.core.ppu_threads, g_ppu.size()); i < x; i++)
-		{
-			const auto target = g_ppu[i];
+		auto target = g_ppu.first();
 
+		for (u32 i = 0; target && i < g_cfg.core.ppu_threads; i++, target = g_ppu.next(*target))
+		{
 			if (test(target->state, cpu_flag::suspend))
 			{
 				LOG_TRACE(PPU, "schedule(): %s", target->id);
@@ -1161,23 +1410,17 @@ void lv2_obj::schedule_all()
 			}
 		}
 	}
+}
 
-	// Check registered timeouts
-	while (!g_waiting.empty())
-	{
-		auto& pair = g_waiting.front();
+void lv2_obj::wait_timeout(u64 usec)
+{
+	const auto thread = thread_ctrl::get_current();
+	const u64 start_time = get_system_time();
+	const auto wheel = fxm::check_unlocked<lv2_timer_thread>();
 
-		if (pair.first <= get_system_time())
-		{
-			pair.second->notify();
-			g_waiting.pop_front();
-		}
-		else
-		{
-			// The list is sorted so assume no more timeouts
-			break;
-		}
-	}
+	wheel->notify_at(thread, start_time + std::min<u64>(usec, ~start_time));
+	thread_ctrl::wait();
+	wheel->cancel(thread);
 }
 
 void ppu_thread::cpu_sleep()
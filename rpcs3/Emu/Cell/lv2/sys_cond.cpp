@@ -239,41 +239,26 @@ error_code sys_cond_wait(ppu_thread& ppu, u32 cond_id, u64 timeout)
 		ppu.gpr[3] = CELL_OK;
 	}
 
-	while (!ppu.state.test_and_reset(cpu_flag::signal))
+	lv2_obj::wait_signal(ppu, timeout, [&]
 	{
-		if (timeout)
-		{
-			const u64 passed = get_system_time() - ppu.start_time;
-
-			if (passed >= timeout)
-			{
-				semaphore_lock lock(cond->mutex->mutex);
+		semaphore_lock lock(cond->mutex->mutex);
 
-				// Try to cancel the waiting
-				if (cond->unqueue(cond->sq, &ppu))
-				{
-					cond->waiters--;
+		// Try to cancel the waiting
+		if (cond->unqueue(cond->sq, &ppu))
+		{
+			cond->waiters--;
 
-					ppu.gpr[3] = CELL_ETIMEDOUT;
+			ppu.gpr[3] = CELL_ETIMEDOUT;
 
-					// Own or requeue
-					if (cond->mutex->try_own(ppu, ppu.id))
-					{
-						break;
-					}
-				}
-
-				timeout = 0;
-				continue;
+			// Own or requeue
+			if (cond->mutex->try_own(ppu, ppu.id))
+			{
+				return true;
 			}
-
-			thread_ctrl::wait_for(timeout - passed);
-		}
-		else
-		{
-			thread_ctrl::wait();
 		}
-	}
+
+		return false;
+	});
 
 	// Verify ownership
 	verify(HERE), cond->mutex->owner >> 1 == ppu.id;
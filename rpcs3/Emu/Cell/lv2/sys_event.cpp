@@ -289,7 +289,7 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
@@ -179,7 +179,7 @@ error_code sys_event_flag_wait(ppu_thread& ppu, u32 id, u64 bitptn, u32 mode, vm
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
@@ -300,7 +300,7 @@ error_code _sys_lwcond_queue_wait(ppu_thread& ppu, u32 lwcond_id, u32 lwmutex_id
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
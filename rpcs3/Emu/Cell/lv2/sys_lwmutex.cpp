@@ -73,16 +73,26 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 {
 	sys_lwmutex.trace("_sys_lwmutex_lock(lwmutex_id=0x%x, timeout=0x%llx)", lwmutex_id, timeout);
 
-	const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id, [&](lv2_lwmutex& mutex)
+	// Spin without holding the ID manager lock
+	if (const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id))
 	{
-		if (u32 value = mutex.signaled)
+		if (lv2_obj::spin_acquire(mutex->spins, [&]
 		{
-			if (mutex.signaled.compare_and_swap_test(value, value - 1))
-			{
-				return true;
-			}
+			const u32 value = mutex->signaled;
+			return value && mutex->signaled.compare_and_swap_test(value, value - 1);
+		}))
+		{
+			return CELL_OK;
 		}
+	}
+	else
+	{
+		return CELL_ESRCH;
+	}
 
+	// Queue under the ID manager lock
+	const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id, [&](lv2_lwmutex& mutex)
+	{
 		semaphore_lock lock(mutex.mutex);
 
 		if (u32 value = mutex.signaled)
@@ -110,33 +120,18 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 
 	ppu.gpr[3] = CELL_OK;
 
-	while (!ppu.state.test_and_reset(cpu_flag::signal))
+	lv2_obj::wait_signal(ppu, timeout, [&]
 	{
-		if (timeout)
-		{
-			const u64 passed = get_system_time() - ppu.start_time;
-
-			if (passed >= timeout)
-			{
-				semaphore_lock lock(mutex->mutex);
-
-				if (!mutex->unqueue(mutex->sq, &ppu))
-				{
-					timeout = 0;
-					continue;
-				}
+		semaphore_lock lock(mutex->mutex);
 
-				ppu.gpr[3] = CELL_ETIMEDOUT;
-				break;
-			}
-
-			thread_ctrl::wait_for(timeout - passed);
-		}
-		else
+		if (!mutex->unqueue(mutex->sq, &ppu))
 		{
-			thread_ctrl::wait();
+			return false;
 		}
-	}
+
+		ppu.gpr[3] = CELL_ETIMEDOUT;
+		return true;
+	});
 
 	return not_an_error(ppu.gpr[3]);
 }
@@ -110,25 +110,43 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 {
 	sys_mutex.trace("sys_mutex_lock(mutex_id=0x%x, timeout=0x%llx)", mutex_id, timeout);
 
-	const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex)
+	// Spin without holding the ID manager lock
+	if (const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id))
 	{
-		CellError result = mutex.try_lock(ppu.id);
+		CellError result = mutex->try_lock(ppu.id);
 
-		if (result == CELL_EBUSY)
+		if (result == CELL_EBUSY && lv2_obj::spin_acquire(mutex->spins, [&] { return !mutex->try_lock(ppu.id); }))
 		{
-			semaphore_lock lock(mutex.mutex);
-
-			if (mutex.try_own(ppu, ppu.id))
-			{
-				result = {};
-			}
-			else
-			{
-				mutex.sleep(ppu, timeout);
-			}
+			result = {};
 		}
 
-		return result;
+		if (!result)
+		{
+			return CELL_OK;
+		}
+
+		if (result != CELL_EBUSY)
+		{
+			return result;
+		}
+	}
+	else
+	{
+		return CELL_ESRCH;
+	}
+
+	// Queue under the ID manager lock
+	const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex) -> CellError
+	{
+		semaphore_lock lock(mutex.mutex);
+
+		if (mutex.try_own(ppu, ppu.id))
+		{
+			return {};
+		}
+
+		mutex.sleep(ppu, timeout);
+		return CELL_EBUSY;
 	});
 
 	if (!mutex)
@@ -150,33 +168,18 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 
 	ppu.gpr[3] = CELL_OK;
 
-	while (!ppu.state.test_and_reset(cpu_flag::signal))
+	lv2_obj::wait_signal(ppu, timeout, [&]
 	{
-		if (timeout)
-		{
-			const u64 passed = get_system_time() - ppu.start_time;
-
-			if (passed >= timeout)
-			{
-				semaphore_lock lock(mutex->mutex);
-
-				if (!mutex->unqueue(mutex->sq, &ppu))
-				{
-					timeout = 0;
-					continue;
-				}
-
-				ppu.gpr[3] = CELL_ETIMEDOUT;
-				break;
-			}
+		semaphore_lock lock(mutex->mutex);
 
-			thread_ctrl::wait_for(timeout - passed);
-		}
-		else
+		if (!mutex->unqueue(mutex->sq, &ppu))
 		{
-			thread_ctrl::wait();
+			return false;
 		}
-	}
+
+		ppu.gpr[3] = CELL_ETIMEDOUT;
+		return true;
+	});
 
 	return not_an_error(ppu.gpr[3]);
 }
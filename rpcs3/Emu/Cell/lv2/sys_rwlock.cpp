@@ -147,7 +147,7 @@ error_code sys_rwlock_rlock(ppu_thread& ppu, u32 rw_lock_id, u64 timeout)
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
@@ -349,7 +349,7 @@ error_code sys_rwlock_wlock(ppu_thread& ppu, u32 rw_lock_id, u64 timeout)
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
@@ -149,7 +149,7 @@ error_code sys_semaphore_wait(ppu_thread& ppu, u32 sem_id, u64 timeout)
 				break;
 			}
 
-			thread_ctrl::wait_for(timeout - passed);
+			lv2_obj::wait_timeout(timeout - passed);
 		}
 		else
 		{
@@ -777,6 +777,9 @@ error_code sys_spu_thread_write_ls(u32 id, u32 lsa, u64 value, u32 type)
 	default: return CELL_EINVAL;
 	}
 
+	// Invalidate compiled code using the modified LS page
+	thread->notify_ls_write(lsa, type);
+
 	return CELL_OK;
 }
 
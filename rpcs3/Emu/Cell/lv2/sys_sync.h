@@ -55,6 +55,10 @@ enum
 	SYS_SYNC_ATTR_ADAPTIVE_MASK  = 0xf000,
 };
 
+class ppu_thread;
+
+extern u64 get_system_time();
+
 // Base class for some kernel objects (shared set of 8192 objects).
 struct lv2_obj
 {
@@ -113,6 +117,83 @@ struct lv2_obj
 		return res;
 	}
 
+	// Spin limit (in rounds of busy_wait(10)) before sleeping on a contended object
+	static const u32 max_spin_count = 100;
+
+	// Try to acquire the object by spinning before going to sleep
+	// The spin estimate of the object follows how long spinning takes to succeed, and decays when spinning fails
+	template <typename F>
+	static bool spin_acquire(atomic_t<s32>& spins, F&& try_acquire)
+	{
+		const s32 limit = std::min<s32>(max_spin_count, spins * 2 + 10);
+
+		s32 count = 0;
+		bool result = false;
+
+		for (; count < limit; count++)
+		{
+			if ((result = try_acquire()))
+			{
+				break;
+			}
+
+			busy_wait(10);
+		}
+
+		if (result)
+		{
+			spins += (count - spins) / 8;
+		}
+		else
+		{
+			// Spinning didn't help, spin less next time
+			spins -= (spins + 7) / 8;
+		}
+
+		return result;
+	}
+
+	// Wait for the wakeup (cpu_flag::signal) after sleep(), spinning briefly before blocking
+	// on_timeout() is called after the timeout has passed, it returns false if the wakeup is still expected
+	template <typename T, typename F>
+	static void wait_signal(T& thread, u64 timeout, F&& on_timeout)
+	{
+		for (u32 i = 0; i < 16; i++)
+		{
+			if (thread.state.test_and_reset(cpu_flag::signal))
+			{
+				return;
+			}
+
+			busy_wait(10);
+		}
+
+		while (!thread.state.test_and_reset(cpu_flag::signal))
+		{
+			if (timeout)
+			{
+				const u64 passed = get_system_time() - thread.start_time;
+
+				if (passed >= timeout)
+				{
+					if (on_timeout())
+					{
+						break;
+					}
+
+					timeout = 0;
+					continue;
+				}
+
+				wait_timeout(timeout - passed);
+			}
+			else
+			{
+				thread_ctrl::wait();
+			}
+		}
+	}
+
 	// Remove the current thread from the scheduling queue, register timeout
 	static void sleep_timeout(named_thread&, u64 timeout);
 
@@ -122,6 +203,9 @@ struct lv2_obj
 		sleep_timeout(thread, timeout);
 	}
 
+	// Wait for the notification or the timeout (delivered by the timer thread)
+	static void wait_timeout(u64 usec);
+
 	// Schedule the thread
 	static void awake(cpu_thread&, u32 prio);
 
@@ -130,6 +214,9 @@ struct lv2_obj
 		awake(thread, -1);
 	}
 
+	// Create shared objects (the timer thread), must be called before the process starts
+	static void init();
+
 	static void cleanup();
 
 	template <typename T, typename F>
@@ -208,17 +295,73 @@ struct lv2_obj
 	}
 
 private:
+	// Run queues for active PPU threads: one intrusive list per priority and the bitmap of non-empty lists
+	struct run_queue
+	{
+		static constexpr u32 prio_count = 4096;
+
+		std::array<ppu_thread*, prio_count> head{};
+		std::array<ppu_thread*, prio_count> tail{};
+		std::array<u64, prio_count / 64> mask{};
+		u64 summary = 0;
+		u32 count = 0;
+
+		// Append the thread to its priority list
+		void push(ppu_thread& thread);
+
+		// Remove the thread if queued
+		bool remove(ppu_thread& thread);
+
+		// Get the first thread in the scheduling order
+		ppu_thread* first() const;
+
+		// Get the thread following the queued thread
+		ppu_thread* next(const ppu_thread& thread) const;
+
+		void clear();
+	};
+
 	// Scheduler mutex
 	static semaphore<> g_mutex;
 
 	// Scheduler queue for active PPU threads
-	static std::deque<class ppu_thread*> g_ppu;
+	static run_queue g_ppu;
+
+	// Amount of threads waiting for the response from (marked with sched_pending)
+	static u32 g_pending;
+
+	enum : u32
+	{
+		run_count_mask = 0xffff, // Amount of queued threads (including g_wake_list)
+		run_inflight = 0x10000, // A thread is being inserted into g_wake_list
+		run_inflight_mask = 0x7fff0000,
+		run_closed = 0x80000000, // Lock-free wake path disabled (scheduler locked or suspension pending)
+	};
+
+	// Lock-free wake path state
+	static atomic_t<u32> g_run_state;
+
+	// Threads awakened without locking, inserted into g_ppu by the next locked operation
+	static atomic_t<ppu_thread*> g_wake_list;
+
+	// Scheduler lock, also stops the lock-free wake path and processes g_wake_list
+	class sched_lock
+	{
+		semaphore_lock m_lock;
+
+	public:
+		sched_lock();
+		~sched_lock();
+	};
+
+	// Wake the thread without locking if it can take a free running slot
+	static bool try_awake(ppu_thread& thread);
 
-	// Waiting for the response from
-	static std::deque<class cpu_thread*> g_pending;
+	// Request suspension of the thread if it's running
+	static void suspend(ppu_thread& thread);
 
-	// Scheduler queue for timeouts (wait until -> thread)
-	static std::deque<std::pair<u64, named_thread*>> g_waiting;
+	// Remove the thread from pending if necessary
+	static void unqueue_pending(ppu_thread& thread);
 
 	static void schedule_all();
 };
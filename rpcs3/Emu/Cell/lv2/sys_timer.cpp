@@ -17,59 +17,270 @@ logs::channel sys_timer("sys_timer");
 
 extern u64 get_system_time();
 
-void lv2_timer::on_task()
+u64 lv2_timer::check(u64 _now)
 {
-	while (!Emu.IsStopped())
+	semaphore_lock lock(mutex);
+
+	while (state == SYS_TIMER_STATE_RUN)
 	{
-		const u32 _state = state;
+		const u64 next = expire;
+
+		if (_now < next)
+		{
+			return next;
+		}
 
-		if (_state == SYS_TIMER_STATE_RUN)
+		if (const auto queue = port.lock())
 		{
-			const u64 _now = get_system_time();
-			const u64 next = expire;
+			queue->send(source, data1, data2, next);
 
-			if (_now >= next)
+			if (period)
 			{
-				semaphore_lock lock(mutex);
+				// Set next expiration time and check again (HACK)
+				expire += period;
+				continue;
+			}
+		}
 
-				if (const auto queue = port.lock())
-				{
-					queue->send(source, data1, data2, next);
-
-					if (period)
-					{
-						// Set next expiration time and check again (HACK)
-						expire += period;
-						continue;
-					}
-				}
+		// Stop: oneshot or the event port was disconnected (TODO: is it correct?)
+		state = SYS_TIMER_STATE_STOP;
+	}
+
+	return 0;
+}
+
+lv2_timer_thread::lv2_timer_thread()
+	: m_time(get_system_time())
+{
+}
+
+void lv2_timer_thread::link(entry& e)
+{
+	u32 level = 0;
+	u32 index = m_time % slot_count;
+
+	if (e.deadline > m_time)
+	{
+		// Level of the highest slot index differing from the wheel time
+		level = (63 - ::cntlz64(e.deadline ^ m_time, true)) / level_bits;
+		index = (e.deadline >> (level * level_bits)) % slot_count;
+	}
+
+	e.slot = level * slot_count + index;
+	e.prev = nullptr;
+	e.next = m_slots[e.slot];
+
+	if (e.next)
+	{
+		e.next->prev = &e;
+	}
+
+	m_slots[e.slot] = &e;
+	m_bitmap[level] |= 1ull << index;
+}
+
+void lv2_timer_thread::unlink(entry& e)
+{
+	if (e.prev)
+	{
+		e.prev->next = e.next;
+	}
+	else
+	{
+		m_slots[e.slot] = e.next;
+	}
+
+	if (e.next)
+	{
+		e.next->prev = e.prev;
+	}
+
+	if (!m_slots[e.slot])
+	{
+		m_bitmap[e.slot / slot_count] &= ~(1ull << (e.slot % slot_count));
+	}
+}
+
+void lv2_timer_thread::insert(const void* key, u64 deadline, thread_ctrl* thread, u32 timer_id)
+{
+	const auto found = m_entries.emplace(key, entry{});
+	auto& e = found.first->second;
+
+	if (!found.second)
+	{
+		unlink(e);
+	}
+
+	e.key = key;
+	e.deadline = deadline;
+	e.thread = thread;
+	e.timer_id = timer_id;
+	link(e);
+
+	if (deadline < m_next)
+	{
+		// Wake up the dispatcher earlier
+		m_next = deadline;
+		notify();
+	}
+}
+
+void lv2_timer_thread::advance(u64 _now)
+{
+	while (true)
+	{
+		// Find the earliest non-empty slot, lower levels always expire first
+		u32 level = 0;
+		u64 bits = 0;
+
+		for (; level < level_count; level++)
+		{
+			const u32 index = (m_time >> (level * level_bits)) % slot_count;
+
+			if ((bits = m_bitmap[level] & (~0ull << index)))
+			{
+				break;
+			}
+		}
+
+		if (level == level_count)
+		{
+			break;
+		}
+
+		const u32 index = static_cast<u32>(::cnttz64(bits, true));
+		const u32 shift = level * level_bits;
+		const u64 start = (shift + level_bits < 64 ? m_time >> (shift + level_bits) << (shift + level_bits) : 0) | (u64{index} << shift);
+
+		if (start > _now)
+		{
+			break;
+		}
+
+		m_time = std::max(m_time, start);
+
+		entry* list = m_slots[level * slot_count + index];
+		m_slots[level * slot_count + index] = nullptr;
+		m_bitmap[level] &= ~(1ull << index);
+
+		while (list)
+		{
+			entry& e = *list;
+			list = e.next;
 
-				// Stop: oneshot or the event port was disconnected (TODO: is it correct?)
-				state = SYS_TIMER_STATE_STOP;
+			if (e.deadline > _now)
+			{
+				// Cascade to a lower level
+				link(e);
 				continue;
 			}
 
-			// TODO: use single global dedicated thread for busy waiting, no timer threads
-			lv2_obj::sleep_timeout(*this, next - _now);
-			thread_ctrl::wait_for(next - _now);
+			if (e.thread)
+			{
+				e.thread->notify();
+			}
+			else
+			{
+				m_expired.emplace_back(e.timer_id, e.deadline);
+			}
+
+			m_entries.erase(e.key);
 		}
-		else if (_state == SYS_TIMER_STATE_STOP)
+	}
+
+	m_time = std::max(m_time, _now);
+}
+
+u64 lv2_timer_thread::get_next() const
+{
+	for (u32 level = 0; level < level_count; level++)
+	{
+		const u32 index = (m_time >> (level * level_bits)) % slot_count;
+
+		if (const u64 bits = m_bitmap[level] & (~0ull << index))
 		{
-			thread_ctrl::wait_for(10000);
+			// Start of the slot: exact deadline on the first level, lower bound otherwise
+			const u32 shift = level * level_bits;
+			return (shift + level_bits < 64 ? m_time >> (shift + level_bits) << (shift + level_bits) : 0) | (::cnttz64(bits, true) << shift);
 		}
-		else
+	}
+
+	return -1;
+}
+
+void lv2_timer_thread::on_task()
+{
+	thread_ctrl::set_native_priority(1);
+
+	while (!Emu.IsStopped())
+	{
+		u64 next;
+
 		{
-			break;
+			semaphore_lock lock(m_mutex);
+
+			advance(get_system_time());
+			next = m_next = get_next();
+		}
+
+		// Send timer events outside of the lock, reschedule periodic timers
+		for (const auto& expired : m_expired)
+		{
+			if (const auto timer = idm::get<lv2_obj, lv2_timer>(expired.first))
+			{
+				if (const u64 expire = timer->check(get_system_time()))
+				{
+					check_at(*timer, expired.first, expire);
+				}
+			}
+		}
+
+		m_expired.clear();
+
+		const u64 _now = get_system_time();
+
+		if (next > _now)
+		{
+			// Also wake up periodically to check the emulator state
+			thread_ctrl::wait_for(std::min<u64>(next - _now, 10000));
 		}
 	}
 }
 
-void lv2_timer::on_stop()
+void lv2_timer_thread::notify_at(thread_ctrl* thread, u64 deadline)
 {
-	// Signal thread using invalid state
-	state = -1;
-	notify();
-	join();
+	semaphore_lock lock(m_mutex);
+
+	insert(thread, deadline, thread, 0);
+}
+
+void lv2_timer_thread::check_at(const lv2_timer& timer, u32 timer_id, u64 deadline)
+{
+	semaphore_lock lock(m_mutex);
+
+	insert(&timer, deadline, nullptr, timer_id);
+}
+
+void lv2_timer_thread::cancel(const void* key)
+{
+	semaphore_lock lock(m_mutex);
+
+	const auto found = m_entries.find(key);
+
+	if (found != m_entries.end())
+	{
+		unlink(found->second);
+		m_entries.erase(found);
+	}
+}
+
+void lv2_timer_thread::clear()
+{
+	semaphore_lock lock(m_mutex);
+
+	m_entries.clear();
+	m_slots.fill(nullptr);
+	m_bitmap.fill(0);
 }
 
 error_code sys_timer_create(vm::ptr<u32> timer_id)
@@ -111,6 +322,11 @@ error_code sys_timer_destroy(u32 timer_id)
 		return timer.ret;
 	}
 
+	if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+	{
+		wheel->cancel(timer.ptr.get());
+	}
+
 	return CELL_OK;
 }
 
@@ -171,7 +387,7 @@ error_code _sys_timer_start(u32 timer_id, u64 base_time, u64 period)
 		timer.expire = base_time ? base_time : start_time + period;
 		timer.period = period;
 		timer.state  = SYS_TIMER_STATE_RUN;
-		timer.notify();
+		fxm::check_unlocked<lv2_timer_thread>()->check_at(timer, timer_id, timer.expire);
 		return {};
 	});
 
@@ -197,6 +413,11 @@ error_code sys_timer_stop(u32 timer_id)
 		semaphore_lock lock(timer.mutex);
 
 		timer.state = SYS_TIMER_STATE_STOP;
+
+		if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+		{
+			wheel->cancel(&timer);
+		}
 	});
 
 	if (!timer)
@@ -263,6 +484,12 @@ error_code sys_timer_disconnect_event_queue(u32 timer_id)
 
 		timer.state = SYS_TIMER_STATE_STOP;
 		timer.port.reset();
+
+		if (const auto wheel = fxm::check_unlocked<lv2_timer_thread>())
+		{
+			wheel->cancel(&timer);
+		}
+
 		return {};
 	});
 
@@ -300,7 +527,7 @@ error_code sys_timer_usleep(ppu_thread& ppu, u64 sleep_time)
 
 	while (sleep_time >= passed)
 	{
-		thread_ctrl::wait_for(std::max<u64>(1, sleep_time - passed));
+		lv2_obj::wait_timeout(std::max<u64>(1, sleep_time - passed));
 		passed = get_system_time() - ppu.start_time;
 	}
 
@@ -17,13 +17,10 @@ struct sys_timer_information_t
 	be_t<u32> pad;
 };
 
-struct lv2_timer final : public lv2_obj, public named_thread
+struct lv2_timer final : public lv2_obj
 {
 	static const u32 id_base = 0x11000000;
 
-	void on_task() override;
-	void on_stop() override;
-
 	semaphore<> mutex;
 	atomic_t<u32> state{SYS_TIMER_STATE_STOP};
 
@@ -34,6 +31,72 @@ struct lv2_timer final : public lv2_obj, public named_thread
 
 	atomic_t<u64> expire{0}; // Next expiration time
 	atomic_t<u64> period{0}; // Period (oneshot if 0)
+
+	// Send events for all expired periods, returns next expiration time (0 if stopped)
+	u64 check(u64 _now);
+};
+
+// Hierarchical timer wheel serviced by a single thread
+// Fires lv2 timers and wakes up threads waiting with a timeout
+class lv2_timer_thread final : public named_thread
+{
+	// 11 levels of 64 slots cover the whole 64-bit range of microseconds
+	static constexpr u32 level_bits = 6;
+	static constexpr u32 level_count = 11;
+	static constexpr u32 slot_count = 1 << level_bits;
+
+	struct entry
+	{
+		const void* key;
+		u64 deadline;
+		thread_ctrl* thread; // Thread to notify, or null for a timer
+		u32 timer_id;
+		u32 slot;
+		entry* prev;
+		entry* next;
+	};
+
+	semaphore<> m_mutex;
+
+	// Entries by owner (thread or timer), one pending deadline per owner
+	std::unordered_map<const void*, entry> m_entries;
+
+	// Slot lists and non-empty slot bitmaps for every level
+	std::array<entry*, level_count * slot_count> m_slots{};
+	std::array<u64, level_count> m_bitmap{};
+
+	// Wheel time, all entries expire after it
+	u64 m_time;
+
+	// Time the dispatcher is going to wake up at
+	u64 m_next = -1;
+
+	// Expired timers (dispatcher only)
+	std::vector<std::pair<u32, u64>> m_expired;
+
+	void on_task() override;
+
+	std::string get_name() const override { return "lv2 Timer Thread"; }
+
+	void link(entry& e);
+	void unlink(entry& e);
+	void insert(const void* key, u64 deadline, thread_ctrl* thread, u32 timer_id);
+	void advance(u64 _now);
+	u64 get_next() const;
+
+public:
+	lv2_timer_thread();
+
+	// Notify the thread at the specified time
+	void notify_at(thread_ctrl* thread, u64 deadline);
+
+	// Check the timer at the specified time
+	void check_at(const lv2_timer& timer, u32 timer_id, u64 deadline);
+
+	// Remove pending deadline of the thread or timer
+	void cancel(const void* key);
+
+	void clear();
 };
 
 class ppu_thread;
@@ -3,10 +3,69 @@
 
 shared_mutex id_manager::g_mutex;
 
+DECLARE(id_manager::id_reader::s_shards);
+DECLARE(id_manager::id_reader::s_epoch){0};
+
+thread_local u32 id_manager::id_reader::s_shard = []
+{
+	// Assign shards to threads in round-robin order
+	static atomic_t<u32> g_next{0};
+
+	return g_next++ % shard_count;
+}();
+
 thread_local DECLARE(idm::g_id);
 DECLARE(idm::g_map);
+DECLARE(idm::g_view);
 DECLARE(fxm::g_vec);
 
+void id_manager::id_reader::synchronize()
+{
+	// Serialize waiters, readers never touch it
+	static shared_mutex s_mutex;
+
+	writer_lock lock(s_mutex);
+
+	// Flip the epoch twice: readers which loaded the old epoch value but haven't incremented its counter yet are caught by the second pass
+	for (u32 pass = 0; pass < 2; pass++)
+	{
+		const u32 old = s_epoch.fetch_add(1) & 1;
+
+		for (auto& shard : s_shards)
+		{
+			while (shard.ctr[old])
+			{
+				busy_wait();
+			}
+		}
+	}
+}
+
+void idm::publish(u32 type, id_manager::id_map::pointer place)
+{
+	const u32 index = ::narrow<u32>(place - g_map[type].data());
+
+	auto& view = g_view[type];
+
+	verify(HERE), index < view.size, !view.refs.load()[index].exchange(new id_manager::id_ref{place->second, place->first.type()});
+}
+
+id_manager::id_ref* idm::unpublish(u32 type, id_manager::id_map::pointer place)
+{
+	const u32 index = ::narrow<u32>(place - g_map[type].data());
+
+	return g_view[type].refs.load()[index].exchange(nullptr);
+}
+
+void idm::retire(id_manager::id_ref* ref)
+{
+	if (ref)
+	{
+		id_manager::id_reader::synchronize();
+		delete ref;
+	}
+}
+
 id_manager::id_map::pointer idm::allocate_id(const id_manager::id_key& info, u32 base, u32 step, u32 count)
 {
 	// Base type id is stored in value
@@ -15,6 +74,15 @@ id_manager::id_map::pointer idm::allocate_id(const id_manager::id_key& info, u32
 	// Preallocate memory
 	vec.reserve(count);
 
+	auto& view = g_view[info.value()];
+
+	if (!view.refs)
+	{
+		// Allocate published records once, readers may access them at any time
+		view.size = count;
+		view.refs = new atomic_t<id_manager::id_ref*>[count]();
+	}
+
 	if (vec.size() < count)
 	{
 		// Try to emplace back
@@ -50,11 +118,46 @@ void idm::init()
 {
 	// Allocate
 	g_map.resize(id_manager::typeinfo::get_count());
+
+	if (!g_view)
+	{
+		g_view.reset(new id_manager::id_view[id_manager::typeinfo::get_count()]);
+	}
+
 	idm::clear();
 }
 
 void idm::clear()
 {
+	// Unpublish all IDs before finalization
+	std::vector<id_manager::id_ref*> refs;
+
+	for (u32 i = 0; g_view && i < id_manager::typeinfo::get_count(); i++)
+	{
+		auto& view = g_view[i];
+
+		if (const auto data = view.refs.load())
+		{
+			for (u32 j = 0; j < view.size; j++)
+			{
+				if (const auto ref = data[j].exchange(nullptr))
+				{
+					refs.emplace_back(ref);
+				}
+			}
+		}
+	}
+
+	if (!refs.empty())
+	{
+		id_manager::id_reader::synchronize();
+
+		for (auto ref : refs)
+		{
+			delete ref;
+		}
+	}
+
 	// Call recorded finalization functions for all IDs
 	for (auto& map : g_map)
 	{
@@ -172,6 +172,59 @@ namespace id_manager
 	};
 
 	using id_map = std::vector<std::pair<id_key, std::shared_ptr<void>>>;
+
+	// Immutable copy of the ID record published for lock-free readers
+	struct id_ref
+	{
+		std::shared_ptr<void> ptr;
+		u32 type;
+	};
+
+	// Published ID records of the same base type (allocated once, never shrinks)
+	struct id_view
+	{
+		atomic_t<atomic_t<id_ref*>*> refs{nullptr};
+		atomic_t<u32> size{0};
+	};
+
+	// Read-side section of lock-free lookup: unpublished id_ref is not deleted until all sections which could see it are left
+	class id_reader
+	{
+		struct alignas(64) shard_t
+		{
+			atomic_t<u32> ctr[2];
+		};
+
+		static constexpr u32 shard_count = 16;
+
+		// Reader counters for both epoch parities, spread over cache lines
+		static shard_t s_shards[shard_count];
+
+		// Current epoch
+		static atomic_t<u32> s_epoch;
+
+		// Shard of the current thread
+		static thread_local u32 s_shard;
+
+		atomic_t<u32>& m_ctr;
+
+	public:
+		id_reader()
+			: m_ctr(s_shards[s_shard].ctr[s_epoch.load() & 1])
+		{
+			m_ctr++;
+		}
+
+		id_reader(const id_reader&) = delete;
+
+		~id_reader()
+		{
+			m_ctr--;
+		}
+
+		// Wait for all readers started before the call
+		static void synchronize();
+	};
 }
 
 // Object manager for emulated process. Multiple objects of specified arbitrary type are given unique IDs.
@@ -183,6 +236,9 @@ class idm
 	// Type Index -> ID -> Object. Use global since only one process is supported atm.
 	static std::vector<id_manager::id_map> g_map;
 
+	// Type Index -> ID -> Published object (lock-free copy of g_map for get() and check())
+	static std::unique_ptr<id_manager::id_view[]> g_view;
+
 	template <typename T>
 	static inline u32 get_type()
 	{
@@ -294,6 +350,43 @@ class idm
 		return nullptr;
 	}
 
+	// Find published ID record without locking (must be called within id_reader section)
+	template <typename T, typename Type>
+	static id_manager::id_ref* find_ref(u32 id)
+	{
+		static_assert(id_manager::id_verify<T, Type>::value, "Invalid ID type combination");
+
+		const u32 index = get_index<Type>(id);
+
+		auto& view = g_view[get_type<T>()];
+
+		const auto refs = view.refs.load();
+
+		if (!refs || index >= view.size || index >= id_manager::id_traits<Type>::count)
+		{
+			return nullptr;
+		}
+
+		if (const auto ref = refs[index].load())
+		{
+			if (std::is_same<T, Type>::value || ref->type == get_type<Type>())
+			{
+				return ref;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Publish the ID record for lock-free readers (called under writer lock)
+	static void publish(u32 type, id_manager::id_map::pointer place);
+
+	// Unpublish the ID record (called under writer lock), the result must be passed to retire()
+	static id_manager::id_ref* unpublish(u32 type, id_manager::id_map::pointer place);
+
+	// Delete unpublished ID record after all readers are finished (called without lock)
+	static void retire(id_manager::id_ref* ref);
+
 	// Allocate new ID and assign the object from the provider()
 	template <typename T, typename Type, typename F>
 	static id_manager::id_map::pointer create_id(F&& provider)
@@ -316,6 +409,7 @@ class idm
 
 			if (place->second)
 			{
+				publish(get_type<T>(), place);
 				return place;
 			}
 		}
@@ -407,13 +501,18 @@ public:
 		return nullptr;
 	}
 
-	// Check the ID
+	// Check the ID (lock-free)
 	template <typename T, typename Get = T>
 	static inline Get* check(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		id_manager::id_reader lock;
+
+		if (const auto ref = find_ref<T, Get>(id))
+		{
+			return static_cast<Get*>(ref->ptr.get());
+		}
 
-		return check_unlocked<T, Get>(id);
+		return nullptr;
 	}
 
 	// Check the ID, access object under shared lock
@@ -459,20 +558,20 @@ public:
 		return {found->second, static_cast<Get*>(found->second.get())};
 	}
 
-	// Get the object
+	// Get the object (lock-free)
 	template <typename T, typename Get = T>
 	static inline std::shared_ptr<Get> get(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		id_manager::id_reader lock;
 
-		const auto found = find_id<T, Get>(id);
+		const auto ref = find_ref<T, Get>(id);
 
-		if (UNLIKELY(found == nullptr))
+		if (UNLIKELY(ref == nullptr))
 		{
 			return nullptr;
 		}
 
-		return {found->second, static_cast<Get*>(found->second.get())};
+		return {ref->ptr, static_cast<Get*>(ref->ptr.get())};
 	}
 
 	// Get the object, access object under reader lock
@@ -575,11 +674,13 @@ public:
 	static inline explicit_bool_t remove(u32 id)
 	{
 		std::shared_ptr<void> ptr;
+		id_manager::id_ref* ref;
 		{
 			writer_lock lock(id_manager::g_mutex);
 
 			if (const auto found = find_id<T, Get>(id))
 			{
+				ref = unpublish(get_type<T>(), found);
 				ptr = std::move(found->second);
 			}
 			else
@@ -588,6 +689,7 @@ public:
 			}
 		}
 
+		retire(ref);
 		id_manager::on_stop<Get>::func(static_cast<Get*>(ptr.get()));
 		return true;
 	}
@@ -597,11 +699,13 @@ public:
 	static inline std::shared_ptr<Get> withdraw(u32 id)
 	{
 		std::shared_ptr<void> ptr;
+		id_manager::id_ref* ref;
 		{
 			writer_lock lock(id_manager::g_mutex);
 
 			if (const auto found = find_id<T, Get>(id))
 			{
+				ref = unpublish(get_type<T>(), found);
 				ptr = std::move(found->second);
 			}
 			else
@@ -610,6 +714,7 @@ public:
 			}
 		}
 
+		retire(ref);
 		id_manager::on_stop<Get>::func(static_cast<Get*>(ptr.get()));
 		return {ptr, static_cast<Get*>(ptr.get())};
 	}
@@ -621,6 +726,7 @@ public:
 		using result_type = std::shared_ptr<Get>;
 
 		std::shared_ptr<void> ptr;
+		id_manager::id_ref* ref;
 		{
 			writer_lock lock(id_manager::g_mutex);
 
@@ -628,6 +734,7 @@ public:
 			{
 				func(*static_cast<Get*>(found->second.get()));
 
+				ref = unpublish(get_type<T>(), found);
 				ptr = std::move(found->second);
 			}
 			else
@@ -636,6 +743,7 @@ public:
 			}
 		}
 
+		retire(ref);
 		id_manager::on_stop<Get>::func(static_cast<Get*>(ptr.get()));
 		return result_type{ptr, static_cast<Get*>(ptr.get())};
 	}
@@ -647,6 +755,7 @@ public:
 		using result_type = return_pair<Get, FRT>;
 
 		std::shared_ptr<void> ptr;
+		id_manager::id_ref* ref;
 		FRT ret;
 		{
 			writer_lock lock(id_manager::g_mutex);
@@ -662,6 +771,7 @@ public:
 					return result_type{{found->second, _ptr}, std::move(ret)};
 				}
 
+				ref = unpublish(get_type<T>(), found);
 				ptr = std::move(found->second);
 			}
 			else
@@ -670,6 +780,7 @@ public:
 			}
 		}
 
+		retire(ref);
 		id_manager::on_stop<Get>::func(static_cast<Get*>(ptr.get()));
 		return result_type{{ptr, static_cast<Get*>(ptr.get())}, std::move(ret)};
 	}
@@ -39,6 +39,7 @@ u32 VirtualMemoryBlock::Map(u32 realaddr, u32 size)
 		if (!is_good_addr) continue;
 
 		m_mapped_memory.emplace_back(addr, realaddr, size);
+		m_revision++;
 
 		return addr;
 	}
@@ -67,6 +68,7 @@ bool VirtualMemoryBlock::Map(u32 realaddr, u32 size, u32 addr)
 	}
 
 	m_mapped_memory.emplace_back(addr, realaddr, size);
+	m_revision++;
 	return true;
 }
 
@@ -78,6 +80,7 @@ bool VirtualMemoryBlock::UnmapRealAddress(u32 realaddr, u32& size)
 		{
 			size = m_mapped_memory[i].size;
 			m_mapped_memory.erase(m_mapped_memory.begin() + i);
+			m_revision++;
 			return true;
 		}
 	}
@@ -93,6 +96,7 @@ bool VirtualMemoryBlock::UnmapAddress(u32 addr, u32& size)
 		{
 			size = m_mapped_memory[i].size;
 			m_mapped_memory.erase(m_mapped_memory.begin() + i);
+			m_revision++;
 			return true;
 		}
 	}
@@ -132,6 +136,22 @@ bool VirtualMemoryBlock::getRealAddr(u32 addr, u32& result)
 	return false;
 }
 
+bool VirtualMemoryBlock::getMappedRange(u32 addr, u32& start, u32& size, u32& real_start)
+{
+	for (u32 i = 0; i<m_mapped_memory.size(); ++i)
+	{
+		if (addr >= m_mapped_memory[i].addr && addr < m_mapped_memory[i].addr + m_mapped_memory[i].size)
+		{
+			start = m_mapped_memory[i].addr;
+			size = m_mapped_memory[i].size;
+			real_start = m_mapped_memory[i].realAddress;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 u32 VirtualMemoryBlock::getMappedAddress(u32 realAddress)
 {
 	for (u32 i = 0; i<m_mapped_memory.size(); ++i)
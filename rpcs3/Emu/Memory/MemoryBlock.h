@@ -42,11 +42,14 @@ class VirtualMemoryBlock
 	u32 m_range_start = 0;
 	u32 m_range_size = 0;
 
+	// Incremented whenever the mapping table changes
+	atomic_t<u32> m_revision{0};
+
 public:
 	VirtualMemoryBlock() = default;
 
 	VirtualMemoryBlock* SetRange(const u32 start, const u32 size);
-	void Clear() { m_mapped_memory.clear(); m_reserve_size = 0; m_range_start = 0; m_range_size = 0; }
+	void Clear() { m_mapped_memory.clear(); m_reserve_size = 0; m_range_start = 0; m_range_size = 0; m_revision++; }
 	u32 GetStartAddr() const { return m_range_start; }
 	u32 GetSize() const { return m_range_size; }
 	bool IsInMyRange(const u32 addr, const u32 size);
@@ -79,6 +82,13 @@ public:
 	// return true for success
 	bool getRealAddr(u32 addr, u32& result);
 
+	// try to get the mapped range containing addr (the one getRealAddr would use)
+	// return true for success
+	bool getMappedRange(u32 addr, u32& start, u32& size, u32& real_start);
+
+	// mapping table revision, can be used to invalidate cached translations
+	u32 GetRevision() const { return m_revision.load(); }
+
 	u32 RealAddr(u32 addr)
 	{
 		u32 realAddr = 0;
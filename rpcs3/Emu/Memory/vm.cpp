@@ -9,7 +9,6 @@
 #include "Emu/RSX/GSRender.h"
 
 #include <atomic>
-#include <deque>
 
 namespace vm
 {
@@ -39,15 +38,53 @@ namespace vm
 	// Memory locations
 	std::vector<std::shared_ptr<block_t>> g_locations;
 
-	// Reservations (lock lines) in a single memory page
-	using reservation_info = std::array<std::atomic<u64>, 4096 / 128>;
+	// Reservation stamps (one per 128-byte line), only reserved: pages are committed on first access by reservation_fault()
+	// Stamps of unmapped lines are also read before the memory access faults, this commits a zeroed page
+	std::atomic<u64>* const g_reservations = static_cast<std::atomic<u64>*>(utils::memory_reserve(0x100000000 / 128 * sizeof(u64)));
 
-	// Registered waiters
-	std::deque<vm::waiter*> g_waiters;
+	// Committed pages of the reservation stamps (bitmap)
+	std::array<atomic_t<u64>, 0x100000000 / 128 * sizeof(u64) / 4096 / 64> g_reservation_pages{};
+
+	// Registered waiters (hashed by 128-byte line, independent of g_mutex)
+	struct alignas(64) waiter_bucket
+	{
+		shared_mutex mutex;
+
+		// Waiters of all lines mapped to the bucket
+		std::vector<vm::waiter*> list;
+	};
+
+	std::array<waiter_bucket, 256> g_waiters;
+
+	static inline waiter_bucket& get_waiter_bucket(u32 line)
+	{
+		return g_waiters[line % g_waiters.size()];
+	}
 
 	// Memory mutex core
 	shared_mutex g_mutex;
 
+	// Reservation lock stripes (hashed by 128-byte line)
+	struct alignas(64) reservation_stripe
+	{
+		shared_mutex mutex;
+
+		// Number of times the exclusive lock was found busy (stats)
+		atomic_t<u64> contention{0};
+	};
+
+	std::array<reservation_stripe, 256> g_reservation_locks;
+
+	static inline reservation_stripe& get_reservation_stripe(u32 addr)
+	{
+		return g_reservation_locks[(addr / 128) % g_reservation_locks.size()];
+	}
+
+	static inline shared_mutex& get_reservation_lock(u32 addr)
+	{
+		return get_reservation_stripe(addr).mutex;
+	}
+
 	// Memory mutex acknowledgement
 	thread_local atomic_t<cpu_thread*>* g_tls_locked = nullptr;
 
@@ -209,76 +246,129 @@ namespace vm
 		}
 	}
 
-	// Page information
-	struct memory_page
+	reservation_lock::reservation_lock(u32 addr, bool exclusive)
+		: addr(addr)
+		, exclusive(exclusive)
+		, locked(true)
 	{
-		// Memory flags
-		atomic_t<u8> flags;
+		const auto cpu = get_current_cpu_thread();
 
-		atomic_t<u32> waiters;
+		// Passive lock already prevents mapping changes, otherwise block them with the reader lock
+		if (!cpu || !g_tls_locked || *g_tls_locked != cpu)
+		{
+			g_mutex.lock_shared();
+			mapping_locked = true;
+		}
 
-		// Reservations
-		atomic_t<reservation_info*> reservations;
+		auto& stripe = get_reservation_stripe(addr);
 
-		// Access reservation info
-		std::atomic<u64>& operator [](u32 addr)
+		if (exclusive)
 		{
-			auto ptr = reservations.load();
-
-			if (!ptr)
+			if (!stripe.mutex.try_lock())
 			{
-				// Opportunistic memory allocation
-				ptr = new reservation_info{};
+				stripe.contention++;
+				stripe.mutex.lock();
+			}
+		}
+		else
+		{
+			stripe.mutex.lock_shared();
+		}
+	}
 
-				if (auto old_ptr = reservations.compare_and_swap(nullptr, ptr))
-				{
-					delete ptr;
-					ptr = old_ptr;
-				}
+	reservation_lock::reservation_lock(u32 addr, const try_to_lock_t&)
+		: addr(addr)
+		, exclusive(false)
+		, locked(get_reservation_lock(addr).try_lock_shared())
+	{
+	}
+
+	reservation_lock::~reservation_lock()
+	{
+		if (locked)
+		{
+			if (exclusive)
+			{
+				get_reservation_lock(addr).unlock();
+			}
+			else
+			{
+				get_reservation_lock(addr).unlock_shared();
 			}
+		}
 
-			return (*ptr)[(addr & 0xfff) >> 7];
+		if (mapping_locked)
+		{
+			g_mutex.unlock_shared();
 		}
+	}
+
+	// Page information
+	struct memory_page
+	{
+		// Memory flags
+		atomic_t<u8> flags;
+
+		// Number of registered waiters
+		atomic_t<u32> waiters;
 	};
 
 	// Memory pages
 	std::array<memory_page, 0x100000000 / 4096> g_pages{};
 
-	u64 reservation_acquire(u32 addr, u32 _size)
-	{
-		// Access reservation info: stamp and the lock bit
-		return g_pages[addr >> 12][addr].load(std::memory_order_acquire);
-	}
-
 	void reservation_update(u32 addr, u32 _size)
 	{
-		// Update reservation info with new timestamp (unsafe, assume allocated)
-		(*g_pages[addr >> 12].reservations)[(addr & 0xfff) >> 7].store(__rdtsc(), std::memory_order_release);
+		// Update reservation info with new timestamp (the lowest bit is reserved for reservation_lock_stamp)
+		g_reservations[addr / 128].store(__rdtsc() & ~1ull, std::memory_order_release);
 	}
 
-	void waiter::init()
+	bool reservation_fault(const void* ptr)
 	{
-		// Register waiter
-		writer_lock lock(0);
+		const u64 offset = reinterpret_cast<u64>(ptr) - reinterpret_cast<u64>(g_reservations);
+
+		if (offset >= 0x100000000 / 128 * sizeof(u64))
+		{
+			return false;
+		}
 
-		g_waiters.emplace_back(this);
+		// Committing the same page concurrently is harmless
+		const u32 page = static_cast<u32>(offset / 4096);
+		utils::memory_commit(reinterpret_cast<u8*>(g_reservations) + page * 4096, 4096);
+		g_reservation_pages[page / 64] |= 1ull << (page % 64);
+		return true;
 	}
 
-	void waiter::test() const
+	u64 reservation_contention()
 	{
-		if (std::memcmp(data, vm::base(addr), size) == 0)
+		u64 result = 0;
+
+		for (auto& stripe : g_reservation_locks)
 		{
-			return;
+			result += stripe.contention;
 		}
 
-		memory_page& page = g_pages[addr >> 12];
+		return result;
+	}
 
-		if (page.reservations == nullptr)
+	void waiter::init()
+	{
+		// Register waiter
 		{
-			return;
+			auto& bucket = get_waiter_bucket(addr / 128);
+
+			::writer_lock lock(bucket.mutex);
+
+			bucket.list.emplace_back(this);
 		}
 
-		if (stamp >= (*page.reservations)[(addr & 0xfff) >> 7].load())
+		// Must be visible before the caller tests the condition (pairs with the fence in notify)
+		g_pages[addr >> 12].waiters++;
+		registered = true;
+	}
+
+	void waiter::test() const
+	{
+		if (std::memcmp(data, vm::base(addr), size) == 0 && stamp >= reservation_acquire(addr, size))
 		{
 			return;
 		}
@@ -291,34 +381,86 @@ namespace vm
 
 	waiter::~waiter()
 	{
+		if (!registered)
+		{
+			return;
+		}
+
+		g_pages[addr >> 12].waiters--;
+
 		// Unregister waiter
-		writer_lock lock(0);
+		auto& bucket = get_waiter_bucket(addr / 128);
 
-		// Find waiter
-		const auto found = std::find(g_waiters.cbegin(), g_waiters.cend(), this);
+		::writer_lock lock(bucket.mutex);
 
-		if (found != g_waiters.cend())
+		// Find waiter (order is not important)
+		for (auto& ptr : bucket.list)
 		{
-			g_waiters.erase(found);
+			if (ptr == this)
+			{
+				ptr = bucket.list.back();
+				bucket.list.pop_back();
+				break;
+			}
 		}
 	}
 
 	void notify(u32 addr, u32 size)
 	{
-		for (const waiter* ptr : g_waiters)
+		if (!size)
+		{
+			return;
+		}
+
+		// Pairs with waiter::init
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		const u32 end = addr + (size - 1);
+
+		for (u32 page = addr >> 12;; page++)
 		{
-			if (ptr->addr / 128 == addr / 128)
+			if (g_pages[page].waiters)
 			{
-				ptr->test();
+				break;
+			}
+
+			if (page == end >> 12)
+			{
+				return;
+			}
+		}
+
+		const u32 first = addr / 128;
+		const u32 count = end / 128 - first + 1;
+
+		// Visit each bucket only once for large ranges
+		for (u32 i = 0; i < std::min<u32>(count, ::size32(g_waiters)); i++)
+		{
+			auto& bucket = get_waiter_bucket(first + i);
+
+			::reader_lock lock(bucket.mutex);
+
+			for (auto ptr : bucket.list)
+			{
+				// Skip waiters of other lines sharing the bucket
+				if (ptr->addr / 128 - first < count)
+				{
+					ptr->test();
+				}
 			}
 		}
 	}
 
 	void notify_all()
 	{
-		for (const waiter* ptr : g_waiters)
+		for (auto& bucket : g_waiters)
 		{
-			ptr->test();
+			::reader_lock lock(bucket.mutex);
+
+			for (auto ptr : bucket.list)
+			{
+				ptr->test();
+			}
 		}
 	}
 
@@ -802,6 +944,33 @@ namespace vm
 	{
 		g_locations.clear();
 
+		if (const u64 count = reservation_contention())
+		{
+			LOG_NOTICE(MEMORY, "Reservation contention: %llu", count);
+		}
+
+		for (auto& stripe : g_reservation_locks)
+		{
+			stripe.contention = 0;
+		}
+
+		// Reset reservation stamps: decommit touched pages only, they are committed again (zeroed) on access
+		for (u32 i = 0; i < g_reservation_pages.size(); i++)
+		{
+			u64 bits = g_reservation_pages[i].exchange(0);
+
+			while (bits)
+			{
+				// Decommit contiguous pages at once
+				const u32 first = static_cast<u32>(::cnttz64(bits, true));
+				const u32 count = static_cast<u32>(::cnttz64(~(bits >> first)));
+
+				utils::memory_decommit(reinterpret_cast<u8*>(g_reservations) + (i * 64 + first) * 4096, count * 4096);
+
+				bits &= count == 64 ? 0 : ~(((1ull << count) - 1) << first);
+			}
+		}
+
 		utils::memory_decommit(g_base_addr, 0x100000000);
 		utils::memory_decommit(g_exec_addr, 0x100000000);
 		utils::memory_decommit(g_stat_addr, 0x100000000);
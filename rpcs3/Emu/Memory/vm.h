@@ -3,6 +3,7 @@
 #include <map>
 #include <functional>
 #include <memory>
+#include <atomic>
 
 class named_thread;
 class cpu_thread;
@@ -45,6 +46,7 @@ namespace vm
 		u32 size;
 		u64 stamp;
 		const void* data;
+		bool registered = false;
 
 		waiter() = default;
 
@@ -100,12 +102,46 @@ namespace vm
 		explicit operator bool() const { return locked; }
 	};
 
+	// Lock a single reservation line (128 bytes): exclusive for updates, shared for consistent reads
+	struct reservation_lock final
+	{
+		const u32 addr;
+		const bool exclusive;
+		bool locked;
+		bool mapping_locked = false;
+
+		reservation_lock(const reservation_lock&) = delete;
+		reservation_lock(u32 addr, bool exclusive = true);
+		reservation_lock(u32 addr, const try_to_lock_t&); // Shared, for use in transactions
+		~reservation_lock();
+
+		explicit operator bool() const { return locked; }
+	};
+
+	// Reservation stamps (one per 128-byte line)
+	extern std::atomic<u64>* const g_reservations;
+
+	// Commit the page of reservation stamps at the faulting address (returns false if the address is elsewhere)
+	bool reservation_fault(const void* ptr);
+
 	// Get reservation status for further atomic update: last update timestamp
-	u64 reservation_acquire(u32 addr, u32 size);
+	inline u64 reservation_acquire(u32 addr, u32 size)
+	{
+		return g_reservations[addr / 128].load(std::memory_order_acquire);
+	}
 
-	// End atomic update
+	// Mark the line as being written (odd stamp): lock-free readers of the data must retry until reservation_update
+	inline void reservation_lock_stamp(u32 addr, u32 size)
+	{
+		g_reservations[addr / 128].fetch_or(1);
+	}
+
+	// End atomic update (sets new even stamp)
 	void reservation_update(u32 addr, u32 size);
 
+	// Get the number of contended reservation updates (stats)
+	u64 reservation_contention();
+
 	// Check and notify memory changes at address
 	void notify(u32 addr, u32 size);
 
@@ -15,6 +15,8 @@ const bool s_use_ssse3 =
 #define _mm_shuffle_epi8
 #endif
 
+const bool s_use_avx2 = utils::has_avx2();
+
 namespace
 {
 	// FIXME: GSL as_span break build if template parameter is non const with current revision.
@@ -522,6 +524,266 @@ void write_vertex_array_data_to_buffer(gsl::span<gsl::byte> raw_dst_span, gsl::s
 	}
 }
 
+namespace
+{
+	// Index kernels only consume whole 256-bit blocks, the remainder is always left to the scalar loops
+	template <typename T>
+	constexpr u32 avx2_index_lanes()
+	{
+		return 32 / sizeof(T);
+	}
+
+	AVX2_FUNC inline __m256i avx2_bswap_indices(__m256i v, u16)
+	{
+		const __m256i mask = _mm256_setr_epi8(
+			1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+			1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+		return _mm256_shuffle_epi8(v, mask);
+	}
+
+	AVX2_FUNC inline __m256i avx2_bswap_indices(__m256i v, u32)
+	{
+		const __m256i mask = _mm256_setr_epi8(
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+		return _mm256_shuffle_epi8(v, mask);
+	}
+
+	AVX2_FUNC inline __m256i avx2_broadcast_index(u16 value)
+	{
+		return _mm256_set1_epi16((s16)value);
+	}
+
+	AVX2_FUNC inline __m256i avx2_broadcast_index(u32 value)
+	{
+		return _mm256_set1_epi32((s32)value);
+	}
+
+	AVX2_FUNC inline __m256i avx2_cmpeq_indices(__m256i a, __m256i b, u16)
+	{
+		return _mm256_cmpeq_epi16(a, b);
+	}
+
+	AVX2_FUNC inline __m256i avx2_cmpeq_indices(__m256i a, __m256i b, u32)
+	{
+		return _mm256_cmpeq_epi32(a, b);
+	}
+
+	AVX2_FUNC inline __m256i avx2_min_indices(__m256i a, __m256i b, u16)
+	{
+		return _mm256_min_epu16(a, b);
+	}
+
+	AVX2_FUNC inline __m256i avx2_min_indices(__m256i a, __m256i b, u32)
+	{
+		return _mm256_min_epu32(a, b);
+	}
+
+	AVX2_FUNC inline __m256i avx2_max_indices(__m256i a, __m256i b, u16)
+	{
+		return _mm256_max_epu16(a, b);
+	}
+
+	AVX2_FUNC inline __m256i avx2_max_indices(__m256i a, __m256i b, u32)
+	{
+		return _mm256_max_epu32(a, b);
+	}
+
+	template <typename T>
+	AVX2_FUNC inline __m256i avx2_load_indices(const be_t<T>* src)
+	{
+		return avx2_bswap_indices(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), T{});
+	}
+
+	template <typename T>
+	AVX2_FUNC void avx2_merge_min_max(__m256i vmin, __m256i vmax, T& min_index, T& max_index)
+	{
+		alignas(32) T mins[avx2_index_lanes<T>()];
+		alignas(32) T maxs[avx2_index_lanes<T>()];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(mins), vmin);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(maxs), vmax);
+
+		for (u32 i = 0; i < avx2_index_lanes<T>(); ++i)
+		{
+			min_index = std::min(min_index, mins[i]);
+			max_index = std::max(max_index, maxs[i]);
+		}
+	}
+
+	/**
+	 * Byteswap whole blocks of indices while tracking min/max.
+	 * Restart indices are either replaced with -1 or removed from the output when skip_restart is set.
+	 * Returns the index of the first unprocessed source element.
+	 */
+	template <typename T>
+	AVX2_FUNC u32 upload_untouched_avx2(const be_t<T>* src, T* dst, u32 count, u32& dst_idx, bool restart_enabled, bool skip_restart, T restart_index, T& min_index, T& max_index)
+	{
+		constexpr u32 lanes = avx2_index_lanes<T>();
+
+		const __m256i restart = avx2_broadcast_index(restart_index);
+		__m256i vmin = _mm256_set1_epi8(-1);
+		__m256i vmax = _mm256_setzero_si256();
+
+		u32 src_idx = 0;
+		for (; src_idx + lanes <= count; src_idx += lanes)
+		{
+			__m256i v = avx2_load_indices<T>(src + src_idx);
+			const __m256i mask = restart_enabled ? avx2_cmpeq_indices(v, restart, T{}) : _mm256_setzero_si256();
+
+			// Restart lanes turn into -1 which leaves min unaffected, and are zeroed for max
+			v = _mm256_or_si256(v, mask);
+			vmin = avx2_min_indices(vmin, v, T{});
+			vmax = avx2_max_indices(vmax, _mm256_andnot_si256(mask, v), T{});
+
+			if (skip_restart && !_mm256_testz_si256(mask, mask))
+			{
+				// Compact the block, one movemask bit per byte
+				alignas(32) T values[lanes];
+				_mm256_store_si256(reinterpret_cast<__m256i*>(values), v);
+				const u32 bits = _mm256_movemask_epi8(mask);
+
+				for (u32 i = 0; i < lanes; ++i)
+				{
+					if ((bits & (1u << (i * sizeof(T)))) == 0)
+						dst[dst_idx++] = values[i];
+				}
+
+				continue;
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + dst_idx), v);
+			dst_idx += lanes;
+		}
+
+		avx2_merge_min_max<T>(vmin, vmax, min_index, max_index);
+		return src_idx;
+	}
+
+	/**
+	 * Emit triangle fan triangles for whole blocks of indices, starting with an established anchor and previous index.
+	 * Stops at the first block containing a restart or -1 index and returns its position.
+	 */
+	template <typename T>
+	AVX2_FUNC u32 expand_triangle_fan_avx2(const be_t<T>* src, T* dst, u32 src_idx, u32 count, u32& dst_idx, bool restart_enabled, T restart_index, T anchor, T& last_index, T& min_index, T& max_index)
+	{
+		constexpr u32 lanes = avx2_index_lanes<T>();
+
+		const __m256i restart = avx2_broadcast_index(restart_index);
+		__m256i vmin = _mm256_set1_epi8(-1);
+		__m256i vmax = _mm256_setzero_si256();
+
+		for (; src_idx + lanes <= count; src_idx += lanes)
+		{
+			const __m256i v = avx2_load_indices<T>(src + src_idx);
+
+			// -1 doubles as the 'no previous index' marker, leave those blocks to the scalar path as well
+			__m256i mask = avx2_cmpeq_indices(v, _mm256_set1_epi8(-1), T{});
+			if (restart_enabled)
+				mask = _mm256_or_si256(mask, avx2_cmpeq_indices(v, restart, T{}));
+
+			if (!_mm256_testz_si256(mask, mask))
+				break;
+
+			vmin = avx2_min_indices(vmin, v, T{});
+			vmax = avx2_max_indices(vmax, v, T{});
+
+			alignas(32) T values[lanes];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(values), v);
+
+			T* out = dst + dst_idx;
+			for (u32 i = 0; i < lanes; ++i)
+			{
+				out[0] = anchor;
+				out[1] = last_index;
+				out[2] = values[i];
+				last_index = values[i];
+				out += 3;
+			}
+
+			dst_idx += lanes * 3;
+		}
+
+		avx2_merge_min_max<T>(vmin, vmax, min_index, max_index);
+		return src_idx;
+	}
+
+	// Shuffles expanding each quad {0, 1, 2, 3} into {0, 1, 2, 2, 3, 0}, applied to each 128-bit lane
+	AVX2_FUNC inline void avx2_expand_quads(__m256i v, u16* dst)
+	{
+		// Two quads per 128-bit lane, 24 bytes of output
+		const __m256i mask_lo = _mm256_setr_epi8(
+			0, 1, 2, 3, 4, 5, 4, 5, 6, 7, 0, 1, 8, 9, 10, 11,
+			0, 1, 2, 3, 4, 5, 4, 5, 6, 7, 0, 1, 8, 9, 10, 11);
+		const __m256i mask_hi = _mm256_setr_epi8(
+			12, 13, 12, 13, 14, 15, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1,
+			12, 13, 12, 13, 14, 15, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+
+		const __m256i lo = _mm256_shuffle_epi8(v, mask_lo);
+		const __m256i hi = _mm256_shuffle_epi8(v, mask_hi);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(lo));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 8), _mm256_castsi256_si128(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm256_extracti128_si256(lo, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 20), _mm256_extracti128_si256(hi, 1));
+	}
+
+	AVX2_FUNC inline void avx2_expand_quads(__m256i v, u32* dst)
+	{
+		// One quad per 128-bit lane, 24 bytes of output
+		const __m256i mask_lo = _mm256_setr_epi8(
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 8, 9, 10, 11,
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 8, 9, 10, 11);
+		const __m256i mask_hi = _mm256_setr_epi8(
+			12, 13, 14, 15, 0, 1, 2, 3, -1, -1, -1, -1, -1, -1, -1, -1,
+			12, 13, 14, 15, 0, 1, 2, 3, -1, -1, -1, -1, -1, -1, -1, -1);
+
+		const __m256i lo = _mm256_shuffle_epi8(v, mask_lo);
+		const __m256i hi = _mm256_shuffle_epi8(v, mask_hi);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(lo));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 4), _mm256_castsi256_si128(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 6), _mm256_extracti128_si256(lo, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 10), _mm256_extracti128_si256(hi, 1));
+	}
+
+	/**
+	 * Expand whole blocks of quads into triangle pairs. Must start on a quad boundary.
+	 * Stops at the first block containing a restart index and returns its position.
+	 */
+	template <typename T>
+	AVX2_FUNC u32 expand_quads_avx2(const be_t<T>* src, T* dst, u32 src_idx, u32 count, u32& dst_idx, bool restart_enabled, T restart_index, T& min_index, T& max_index)
+	{
+		constexpr u32 lanes = avx2_index_lanes<T>();
+
+		const __m256i restart = avx2_broadcast_index(restart_index);
+		__m256i vmin = _mm256_set1_epi8(-1);
+		__m256i vmax = _mm256_setzero_si256();
+
+		for (; src_idx + lanes <= count; src_idx += lanes)
+		{
+			const __m256i v = avx2_load_indices<T>(src + src_idx);
+
+			if (restart_enabled)
+			{
+				const __m256i mask = avx2_cmpeq_indices(v, restart, T{});
+				if (!_mm256_testz_si256(mask, mask))
+					break;
+			}
+
+			vmin = avx2_min_indices(vmin, v, T{});
+			vmax = avx2_max_indices(vmax, v, T{});
+
+			avx2_expand_quads(v, dst + dst_idx);
+			dst_idx += lanes * 6 / 4;
+		}
+
+		avx2_merge_min_max<T>(vmin, vmax, min_index, max_index);
+		return src_idx;
+	}
+}
+
 namespace
 {
 template<typename T>
@@ -532,13 +794,24 @@ std::tuple<T, T, u32> upload_untouched(gsl::span<to_be_t<const T>> src, gsl::spa
 
 	verify(HERE), (dst.size_bytes() >= src.size_bytes());
 
+	// List types do not need primitive restart. Just skip over this instead
+	const bool skip_restart = rsx::method_registers.current_draw_clause.is_disjoint_primitive;
+	const u32 count = (u32)src.size();
+
 	u32 dst_idx = 0;
-	for (T index : src)
+	u32 src_idx = 0;
+
+	if (s_use_avx2)
+	{
+		src_idx = upload_untouched_avx2<T>(src.data(), dst.data(), count, dst_idx, is_primitive_restart_enabled, skip_restart, primitive_restart_index, min_index, max_index);
+	}
+
+	for (; src_idx < count; ++src_idx)
 	{
+		T index = src[src_idx];
 		if (is_primitive_restart_enabled && index == primitive_restart_index)
 		{
-			// List types do not need primitive restart. Just skip over this instead
-			if (rsx::method_registers.current_draw_clause.is_disjoint_primitive)
+			if (skip_restart)
 				continue;
 
 			index = -1;
@@ -564,15 +837,28 @@ std::tuple<T, T, u32> expand_indexed_triangle_fan(gsl::span<to_be_t<const T>> sr
 
 	verify(HERE), (dst.size() >= 3 * (src.size() - 2));
 
+	const u32 count = (u32)src.size();
+
 	u32 dst_idx = 0;
-	u32 src_idx = 0;
+
+	//Blocks starting before this position are known to contain a restart index
+	u32 vector_idx = 0;
 
 	bool needs_anchor = true;
 	T anchor = invalid_index;
 	T last_index = invalid_index;
 
-	for (size_t src_idx = 0; src_idx < src.size(); ++src_idx)
+	for (u32 src_idx = 0; src_idx < count; ++src_idx)
 	{
+		if (s_use_avx2 && src_idx >= vector_idx && !needs_anchor && last_index != invalid_index)
+		{
+			src_idx = expand_triangle_fan_avx2<T>(src.data(), dst.data(), src_idx, count, dst_idx, is_primitive_restart_enabled, primitive_restart_index, anchor, last_index, min_index, max_index);
+			vector_idx = src_idx + avx2_index_lanes<T>();
+
+			if (src_idx >= count)
+				break;
+		}
+
 		if (needs_anchor)
 		{
 			if (is_primitive_restart_enabled && src[src_idx] == primitive_restart_index)
@@ -619,12 +905,26 @@ std::tuple<T, T, u32> expand_indexed_quads(gsl::span<to_be_t<const T>> src, gsl:
 
 	verify(HERE), (4 * dst.size_bytes() >= 6 * src.size_bytes());
 
+	const u32 count = (u32)src.size();
+
 	u32 dst_idx = 0;
 	u8 set_size = 0;
 	T tmp_indices[4];
 
-	for (int src_idx = 0; src_idx < src.size(); ++src_idx)
+	//Blocks starting before this position are known to contain a restart index
+	u32 vector_idx = 0;
+
+	for (u32 src_idx = 0; src_idx < count; ++src_idx)
 	{
+		if (s_use_avx2 && src_idx >= vector_idx && set_size == 0)
+		{
+			src_idx = expand_quads_avx2<T>(src.data(), dst.data(), src_idx, count, dst_idx, is_primitive_restart_enabled, primitive_restart_index, min_index, max_index);
+			vector_idx = src_idx + avx2_index_lanes<T>();
+
+			if (src_idx >= count)
+				break;
+		}
+
 		T index = src[src_idx];
 		if (is_primitive_restart_enabled && index == primitive_restart_index)
 		{
@@ -2,6 +2,7 @@
 #include <sstream>
 
 #include "ShaderParam.h"
+#include "../RSXVertexProgram.h"
 
 namespace program_common
 {
@@ -128,8 +129,158 @@ namespace glsl
 		fmt::throw_exception("Unknown compare function" HERE);
 	}
 
-	static void insert_vertex_input_fetch(std::stringstream& OS, glsl_rules rules, bool glsl4_compliant=true)
+	/**
+	 * Straight-line input decoding for a known vertex layout.
+	 * Formats, component counts, byte order and frequency mode are resolved at compile time.
+	 */
+	static void insert_specialized_vertex_input_fetch(std::stringstream& OS, glsl_rules rules, const rsx_vertex_fetch_layout& layout)
 	{
+		const std::string vertex_id_name = (rules == glsl_rules_opengl4) ? "gl_VertexID" : "gl_VertexIndex";
+		const char components[] = "xyzw";
+
+		const char* default_values[] =
+		{
+			"vec4(0., 0., 0., 1.)", //position
+			"vec4(0.)", "vec4(0.)", //weight, normals
+			"vec4(1.)", //diffuse
+			"vec4(0.)", "vec4(0.)", //specular, fog
+			"vec4(1.)", //point size
+			"vec4(0.)", //in_7
+			//in_tc registers
+			"vec4(0.)", "vec4(0.)", "vec4(0.)", "vec4(0.)",
+			"vec4(0.)", "vec4(0.)", "vec4(0.)", "vec4(0.)"
+		};
+
+		OS << "int preserve_sign_s16(uint bits)\n";
+		OS << "{\n";
+		OS << "	//convert raw 16 bit value into signed 32-bit integer counterpart\n";
+		OS << "	uint sign = bits & 0x8000;\n";
+		OS << "	if (sign != 0) return int(bits | 0xFFFF0000);\n";
+		OS << "	return int(bits);\n";
+		OS << "}\n\n";
+
+		for (int location = 0; location < 16; ++location)
+		{
+			const u16 attribute = layout.attributes[location];
+			if (!attribute)
+				continue;
+
+			const u32 type = attribute & rsx_vertex_fetch_layout::type_mask;
+			const u32 size = (attribute & rsx_vertex_fetch_layout::size_mask) >> rsx_vertex_fetch_layout::size_shift;
+			const u32 frequency = (attribute & rsx_vertex_fetch_layout::frequency_mask) >> rsx_vertex_fetch_layout::frequency_shift;
+			const bool swap_bytes = (attribute & rsx_vertex_fetch_layout::swap_bytes) != 0;
+			const std::string stream = (attribute & rsx_vertex_fetch_layout::is_volatile) ? "volatile_input_stream" : "persistent_input_stream";
+
+			//Assemble a 16 or 32-bit word from consecutive bytes
+			auto fetch_bits = [&](u32 offset, u32 bytes)
+			{
+				std::string result;
+				for (u32 n = 0; n < bytes; ++n)
+				{
+					const u32 shift = swap_bytes ? (bytes - n - 1) * 8 : n * 8;
+
+					if (n) result += " | ";
+					result += "(texelFetch(" + stream + ", first_byte + " + std::to_string(offset + n) + ").x";
+					if (shift) result += " << " + std::to_string(shift);
+					result += ")";
+				}
+
+				return result;
+			};
+
+			OS << "vec4 fetch_location_" << location << "()\n";
+			OS << "{\n";
+			OS << "	int attribute_flags = input_attributes[" << location << "].w;\n";
+
+			switch (frequency)
+			{
+			case 0:
+				OS << "	int vertex_id = 0;\n";
+				break;
+			case 1:
+				OS << "	int vertex_id = " << vertex_id_name << " - int(vertex_base_index);\n";
+				break;
+			default:
+				//if a vertex modifier is active; vertex_base must be 0 and is ignored
+				OS << "	int vertex_id = " << vertex_id_name << ((attribute & rsx_vertex_fetch_layout::modulo) ? " % " : " / ") << "((attribute_flags >> 13) & 0xFFFF);\n";
+				break;
+			}
+
+			OS << "	int first_byte = (vertex_id * (attribute_flags & 0xFF)) + input_attributes[" << location << "].z;\n";
+			OS << "	vec4 result = vec4(0., 0., 0., 1.);\n";
+
+			for (u32 n = 0; n < size; ++n)
+			{
+				const std::string dst = std::string("	result.") + components[n] + " = ";
+
+				switch (type)
+				{
+				case 0:
+					//signed normalized 16-bit
+					OS << dst << "float(preserve_sign_s16(" << fetch_bits(n * 2, 2) << ")) / 32767.;\n";
+					break;
+				case 1:
+					//float
+					OS << dst << "uintBitsToFloat(" << fetch_bits(n * 4, 4) << ");\n";
+					break;
+				case 2:
+					//half
+					OS << dst << "unpackHalf2x16(" << fetch_bits(n * 2, 2) << ").x;\n";
+					break;
+				case 3:
+					//unsigned byte
+					OS << dst << "float(texelFetch(" << stream << ", first_byte + " << n << ").x) / 255.;\n";
+					break;
+				case 4:
+					//signed word
+					OS << dst << "float(preserve_sign_s16(" << fetch_bits(n * 2, 2) << "));\n";
+					break;
+				case 5:
+					//cmp, always a single component
+					OS << "	uint bits = " << fetch_bits(0, 4) << ";\n";
+					OS << "	result.x = float(preserve_sign_s16((bits & 0x7FF) << 5)) / 32767.;\n";
+					OS << "	result.y = float(preserve_sign_s16(((bits >> 11) & 0x7FF) << 5)) / 32767.;\n";
+					OS << "	result.z = float(preserve_sign_s16(((bits >> 22) & 0x3FF) << 6)) / 32767.;\n";
+					OS << "	result.w = 1.;\n";
+					break;
+				case 6:
+					//ub256
+					OS << dst << "float(texelFetch(" << stream << ", first_byte + " << n << ").x);\n";
+					break;
+				}
+			}
+
+			const bool reverse_order = swap_bytes && (type == 3 || type == 6);
+			OS << "	return " << (reverse_order ? "result.wzyx" : "result") << ";\n";
+			OS << "}\n\n";
+		}
+
+		OS << "vec4 read_location(int location)\n";
+		OS << "{\n";
+		OS << "	switch (location)\n";
+		OS << "	{\n";
+
+		for (int location = 0; location < 16; ++location)
+		{
+			if (layout.attributes[location])
+				OS << "	case " << location << ": return fetch_location_" << location << "();\n";
+			else
+				OS << "	case " << location << ": return " << default_values[location] << ";\n";
+		}
+
+		OS << "	}\n\n";
+		OS << "	return vec4(0.);\n";
+		OS << "}\n\n";
+	}
+
+	static void insert_vertex_input_fetch(std::stringstream& OS, glsl_rules rules, bool glsl4_compliant=true, const rsx_vertex_fetch_layout* layout=nullptr)
+	{
+		if (layout && layout->specialized)
+		{
+			insert_specialized_vertex_input_fetch(OS, rules, *layout);
+			return;
+		}
+
 		std::string vertex_id_name = (rules == glsl_rules_opengl4) ? "gl_VertexID" : "gl_VertexIndex";
 
 		//Actually decode a vertex attribute from a raw byte stream
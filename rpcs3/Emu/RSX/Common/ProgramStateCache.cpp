@@ -26,6 +26,16 @@ size_t vertex_program_storage_hash::operator()(const RSXVertexProgram &program)
 {
 	size_t hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
 	hash ^= program.output_mask;
+
+	if (program.fetch_layout.specialized)
+	{
+		for (const u16 attribute : program.fetch_layout.attributes)
+		{
+			hash ^= attribute;
+			hash += (hash << 1) + (hash << 4) + (hash << 5) + (hash << 7) + (hash << 8) + (hash << 40);
+		}
+	}
+
 	return hash;
 }
 
@@ -35,6 +45,8 @@ bool vertex_program_compare::operator()(const RSXVertexProgram &binary1, const R
 		return false;
 	if (binary1.data.size() != binary2.data.size())
 		return false;
+	if (binary1.fetch_layout != binary2.fetch_layout)
+		return false;
 	if (!binary1.skip_vertex_input_check && !binary2.skip_vertex_input_check && binary1.rsx_vertex_inputs != binary2.rsx_vertex_inputs)
 		return false;
 
@@ -6,6 +6,14 @@
 
 #include "Utilities/GSL.h"
 #include "Utilities/hash.h"
+#include "Utilities/Thread.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <unordered_set>
 
 enum class SHADER_TYPE
 {
@@ -78,6 +86,10 @@ namespace program_hash_util
 * - static void recompile_fragment_program(RSXFragmentProgram *RSXFP, FragmentProgramData& fragmentProgramData, size_t ID);
 * - static void recompile_vertex_program(RSXVertexProgram *RSXVP, VertexProgramData& vertexProgramData, size_t ID);
 * - static PipelineData build_program(VertexProgramData &vertexProgramData, FragmentProgramData &fragmentProgramData, const PipelineProperties &pipelineProperties, const ExtraData& extraData);
+* Batch preloading (preload_programs) additionally requires the recompile steps to be split :
+* - static void decompile_fragment_program(RSXFP, fragmentProgramData, ID) and static void compile_fragment_program(fragmentProgramData);
+* - static void decompile_vertex_program(RSXVP, vertexProgramData, ID) and static void compile_vertex_program(vertexProgramData);
+* - static constexpr bool threadsafe_compile, false if the compile step must run on the calling thread.
 */
 template<typename backend_traits>
 class program_state_cache
@@ -118,6 +130,15 @@ class program_state_cache
 		}
 	};
 
+	// Work item of the asynchronous compiler
+	struct async_job
+	{
+		std::function<void()> work; // Executed on a compiler thread
+		std::function<void()> finalize; // Executed on the render thread after work is done
+		std::exception_ptr error;
+		atomic_t<bool> done{false};
+	};
+
 protected:
 	size_t m_next_id = 0;
 	bool m_cache_miss_flag;
@@ -125,6 +146,142 @@ protected:
 	binary_to_fragment_program m_fragment_shader_cache;
 	std::unordered_map <pipeline_key, pipeline_storage_type, pipeline_key_hash, pipeline_key_compare> m_storage;
 
+	// Number of layout specialized variants compiled per vertex program ucode hash
+	std::unordered_map<size_t, u32> m_vertex_fetch_variants;
+	static constexpr u32 max_vertex_fetch_variants = 8;
+
+	// Asynchronous compilation state (render thread only)
+	std::unordered_set<const void*> m_pending_programs;
+	std::unordered_set<pipeline_key, pipeline_key_hash, pipeline_key_compare> m_pending_pipelines;
+	std::vector<std::shared_ptr<async_job>> m_async_jobs;
+
+	// Compiler threads
+	std::mutex m_async_mutex;
+	std::condition_variable m_async_cv;
+	std::deque<std::shared_ptr<async_job>> m_async_queue;
+	std::vector<std::thread> m_async_threads;
+	bool m_async_exit = false;
+
+	void enqueue_async_job(std::function<void()> work, std::function<void()> finalize)
+	{
+		if (m_async_threads.empty())
+		{
+			// Leave some cores to the emulator threads
+			const u32 thread_count = std::max<u32>(1, std::thread::hardware_concurrency() / 2);
+
+			for (u32 i = 0; i < thread_count; i++)
+			{
+				m_async_threads.emplace_back([this]()
+				{
+					thread_ctrl::set_native_priority(-1);
+
+					std::unique_lock<std::mutex> lock(m_async_mutex);
+
+					while (true)
+					{
+						m_async_cv.wait(lock, [this]() { return m_async_exit || !m_async_queue.empty(); });
+
+						if (m_async_queue.empty())
+						{
+							break;
+						}
+
+						const auto job = std::move(m_async_queue.front());
+						m_async_queue.pop_front();
+						lock.unlock();
+
+						try
+						{
+							job->work();
+						}
+						catch (...)
+						{
+							job->error = std::current_exception();
+						}
+
+						job->done = true;
+						lock.lock();
+					}
+				});
+			}
+		}
+
+		auto job = std::make_shared<async_job>();
+		job->work = std::move(work);
+		job->finalize = std::move(finalize);
+		m_async_jobs.emplace_back(job);
+
+		{
+			std::lock_guard<std::mutex> lock(m_async_mutex);
+			m_async_queue.emplace_back(std::move(job));
+		}
+
+		m_async_cv.notify_one();
+	}
+
+	// Finalize completed jobs, or all jobs if wait is set
+	void process_async_jobs(bool wait)
+	{
+		std::vector<std::shared_ptr<async_job>> completed;
+
+		for (auto It = m_async_jobs.begin(); It != m_async_jobs.end();)
+		{
+			while (wait && !(*It)->done)
+			{
+				std::this_thread::yield();
+			}
+
+			if ((*It)->done)
+			{
+				completed.emplace_back(std::move(*It));
+				It = m_async_jobs.erase(It);
+			}
+			else
+			{
+				++It;
+			}
+		}
+
+		for (const auto& job : completed)
+		{
+			if (job->error)
+			{
+				std::rethrow_exception(job->error);
+			}
+
+			job->finalize();
+		}
+	}
+
+	bool is_pending(const void* program) const
+	{
+		return !m_pending_programs.empty() && m_pending_programs.count(program) != 0;
+	}
+
+	/**
+	* Layout specialized vertex programs are limited to a few fetch variants per ucode.
+	* Returns false if a new variant of rsx_vp should use the generic fetch routine instead.
+	*/
+	bool accept_vertex_fetch_variant(const RSXVertexProgram& rsx_vp)
+	{
+		if (!rsx_vp.fetch_layout.specialized)
+			return true;
+
+		u32& variants = m_vertex_fetch_variants[program_hash_util::vertex_program_utils::get_vertex_program_ucode_hash(rsx_vp)];
+		if (variants >= max_vertex_fetch_variants)
+			return false;
+
+		variants++;
+		return true;
+	}
+
+	static RSXVertexProgram get_generic_fetch_program(const RSXVertexProgram& rsx_vp)
+	{
+		RSXVertexProgram result = rsx_vp;
+		result.fetch_layout.set(nullptr, false);
+		return result;
+	}
+
 	/// bool here to inform that the program was preexisting.
 	std::tuple<const vertex_program_type&, bool> search_vertex_program(const RSXVertexProgram& rsx_vp)
 	{
@@ -133,6 +290,10 @@ protected:
 		{
 			return std::forward_as_tuple(I->second, true);
 		}
+		if (!accept_vertex_fetch_variant(rsx_vp))
+		{
+			return search_vertex_program(get_generic_fetch_program(rsx_vp));
+		}
 		LOG_NOTICE(RSX, "VP not found in buffer!");
 		vertex_program_type& new_shader = m_vertex_shader_cache[rsx_vp];
 		backend_traits::recompile_vertex_program(rsx_vp, new_shader, m_next_id++);
@@ -235,6 +396,19 @@ public:
 	program_state_cache() = default;
 	~program_state_cache()
 	{
+		{
+			std::lock_guard<std::mutex> lock(m_async_mutex);
+			m_async_exit = true;
+			m_async_queue.clear();
+		}
+
+		m_async_cv.notify_all();
+
+		for (auto& thread : m_async_threads)
+		{
+			thread.join();
+		}
+
 		for (auto& pair : m_fragment_shader_cache)
 		{
 			free(pair.first.addr);
@@ -296,9 +470,265 @@ public:
 		return m_storage[key];
 	}
 
+	/**
+	* Decompile and compile a batch of programs on worker threads.
+	* Programs already present in the cache or repeated in the batch are only processed once,
+	* so getGraphicPipelineState only has to link them afterwards.
+	*/
+	void preload_programs(const std::vector<RSXVertexProgram>& vertex_programs, const std::vector<RSXFragmentProgram>& fragment_programs)
+	{
+		std::vector<std::pair<const RSXVertexProgram*, vertex_program_type*>> vp_tasks;
+		std::vector<std::pair<const RSXFragmentProgram*, fragment_program_type*>> fp_tasks;
+		std::vector<size_t> vp_ids, fp_ids;
+
+		for (const auto& rsx_vp : vertex_programs)
+		{
+			if (m_vertex_shader_cache.count(rsx_vp) == 0)
+			{
+				vp_tasks.emplace_back(&rsx_vp, &m_vertex_shader_cache[rsx_vp]);
+				vp_ids.push_back(m_next_id++);
+			}
+		}
+
+		for (const auto& rsx_fp : fragment_programs)
+		{
+			if (m_fragment_shader_cache.count(rsx_fp) == 0)
+			{
+				size_t fragment_program_size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(rsx_fp.addr);
+				gsl::not_null<void*> fragment_program_ucode_copy = malloc(fragment_program_size);
+				std::memcpy(fragment_program_ucode_copy, rsx_fp.addr, fragment_program_size);
+				RSXFragmentProgram new_fp_key = rsx_fp;
+				new_fp_key.addr = fragment_program_ucode_copy;
+
+				fp_tasks.emplace_back(&rsx_fp, &m_fragment_shader_cache[new_fp_key]);
+				fp_ids.push_back(m_next_id++);
+			}
+		}
+
+		const u32 task_count = ::size32(vp_tasks) + ::size32(fp_tasks);
+
+		if (task_count == 0)
+		{
+			return;
+		}
+
+		atomic_t<u32> task_index{0};
+
+		auto worker = [&]()
+		{
+			for (u32 i = task_index++; i < task_count; i = task_index++)
+			{
+				if (i < vp_tasks.size())
+				{
+					backend_traits::decompile_vertex_program(*vp_tasks[i].first, *vp_tasks[i].second, vp_ids[i]);
+
+					if (backend_traits::threadsafe_compile)
+					{
+						backend_traits::compile_vertex_program(*vp_tasks[i].second);
+					}
+				}
+				else
+				{
+					const u32 j = i - ::size32(vp_tasks);
+					backend_traits::decompile_fragment_program(*fp_tasks[j].first, *fp_tasks[j].second, fp_ids[j]);
+
+					if (backend_traits::threadsafe_compile)
+					{
+						backend_traits::compile_fragment_program(*fp_tasks[j].second);
+					}
+				}
+			}
+		};
+
+		// The calling thread participates as well
+		const u32 thread_count = std::min<u32>(task_count, std::max<u32>(1, std::thread::hardware_concurrency()));
+
+		std::vector<std::thread> workers;
+
+		for (u32 i = 1; i < thread_count; i++)
+		{
+			workers.emplace_back(worker);
+		}
+
+		worker();
+
+		for (auto& thread : workers)
+		{
+			thread.join();
+		}
+
+		if (!backend_traits::threadsafe_compile)
+		{
+			for (auto& task : vp_tasks)
+			{
+				backend_traits::compile_vertex_program(*task.second);
+			}
+
+			for (auto& task : fp_tasks)
+			{
+				backend_traits::compile_fragment_program(*task.second);
+			}
+		}
+
+		LOG_NOTICE(RSX, "Preloaded %u vertex and %u fragment programs using %u threads", ::size32(vp_tasks), ::size32(fp_tasks), thread_count);
+	}
+
+	/**
+	* Asynchronous variant of getGraphicPipelineState.
+	* Missing programs and pipelines are queued to compiler threads, returns nullptr until the pipeline is ready.
+	* Pipelines are linked on the calling thread if backend_traits::threadsafe_compile is not set.
+	*/
+	template<typename... Args>
+	pipeline_storage_type* get_graphics_pipeline_async(
+		const RSXVertexProgram& vertexShader,
+		const RSXFragmentProgram& fragmentShader,
+		const pipeline_properties& pipelineProperties,
+		Args&& ...args
+		)
+	{
+		m_cache_miss_flag = false;
+		process_async_jobs(false);
+
+		bool pending = false;
+
+		auto vp_found = m_vertex_shader_cache.find(vertexShader);
+		if (vp_found == m_vertex_shader_cache.end())
+		{
+			if (!accept_vertex_fetch_variant(vertexShader))
+			{
+				return get_graphics_pipeline_async(get_generic_fetch_program(vertexShader), fragmentShader, pipelineProperties, std::forward<Args>(args)...);
+			}
+
+			LOG_NOTICE(RSX, "VP not found in buffer, compiling asynchronously");
+			vp_found = m_vertex_shader_cache.emplace(std::piecewise_construct, std::forward_as_tuple(vertexShader), std::forward_as_tuple()).first;
+
+			const RSXVertexProgram* rsx_vp = &vp_found->first;
+			vertex_program_type* new_shader = &vp_found->second;
+			const size_t id = m_next_id++;
+
+			m_pending_programs.emplace(new_shader);
+			m_cache_miss_flag = true;
+
+			enqueue_async_job([=]()
+			{
+				backend_traits::decompile_vertex_program(*rsx_vp, *new_shader, id);
+
+				if (backend_traits::threadsafe_compile)
+				{
+					backend_traits::compile_vertex_program(*new_shader);
+				}
+			},
+			[=]()
+			{
+				if (!backend_traits::threadsafe_compile)
+				{
+					backend_traits::compile_vertex_program(*new_shader);
+				}
+
+				m_pending_programs.erase(new_shader);
+			});
+		}
+
+		pending |= is_pending(&vp_found->second);
+
+		auto fp_found = m_fragment_shader_cache.find(fragmentShader);
+		if (fp_found == m_fragment_shader_cache.end())
+		{
+			LOG_NOTICE(RSX, "FP not found in buffer, compiling asynchronously");
+			size_t fragment_program_size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(fragmentShader.addr);
+			gsl::not_null<void*> fragment_program_ucode_copy = malloc(fragment_program_size);
+			std::memcpy(fragment_program_ucode_copy, fragmentShader.addr, fragment_program_size);
+			RSXFragmentProgram new_fp_key = fragmentShader;
+			new_fp_key.addr = fragment_program_ucode_copy;
+			fp_found = m_fragment_shader_cache.emplace(std::piecewise_construct, std::forward_as_tuple(new_fp_key), std::forward_as_tuple()).first;
+
+			const RSXFragmentProgram* rsx_fp = &fp_found->first;
+			fragment_program_type* new_shader = &fp_found->second;
+			const size_t id = m_next_id++;
+
+			m_pending_programs.emplace(new_shader);
+			m_cache_miss_flag = true;
+
+			enqueue_async_job([=]()
+			{
+				backend_traits::decompile_fragment_program(*rsx_fp, *new_shader, id);
+
+				if (backend_traits::threadsafe_compile)
+				{
+					backend_traits::compile_fragment_program(*new_shader);
+				}
+			},
+			[=]()
+			{
+				if (!backend_traits::threadsafe_compile)
+				{
+					backend_traits::compile_fragment_program(*new_shader);
+				}
+
+				m_pending_programs.erase(new_shader);
+			});
+		}
+
+		pending |= is_pending(&fp_found->second);
+
+		if (pending)
+		{
+			return nullptr;
+		}
+
+		const vertex_program_type& vertex_program = vp_found->second;
+		const fragment_program_type& fragment_program = fp_found->second;
+
+		pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
+
+		const auto I = m_storage.find(key);
+		if (I != m_storage.end())
+		{
+			return &I->second;
+		}
+
+		m_cache_miss_flag = true;
+
+		if (!backend_traits::threadsafe_compile)
+		{
+			m_storage[key] = backend_traits::build_pipeline(vertex_program, fragment_program, pipelineProperties, std::forward<Args>(args)...);
+			return &m_storage[key];
+		}
+
+		if (m_pending_pipelines.emplace(key).second)
+		{
+			const auto result = std::make_shared<pipeline_storage_type>();
+			const vertex_program_type* vp = &vertex_program;
+			const fragment_program_type* fp = &fragment_program;
+
+			enqueue_async_job([=]()
+			{
+				*result = backend_traits::build_pipeline(*vp, *fp, key.properties, args...);
+			},
+			[=]()
+			{
+				m_storage[key] = std::move(*result);
+				m_pending_pipelines.erase(key);
+			});
+		}
+
+		return nullptr;
+	}
+
+	/**
+	* Check whether the fragment program is compiled (its ucode must still be present at the program address)
+	*/
+	bool is_fragment_program_ready(const RSXFragmentProgram &fragmentShader) const
+	{
+		const auto I = m_fragment_shader_cache.find(fragmentShader);
+		return I != m_fragment_shader_cache.end() && !is_pending(&I->second);
+	}
+
 	size_t get_fragment_constants_buffer_size(const RSXFragmentProgram &fragmentShader) const
 	{
 		const auto I = m_fragment_shader_cache.find(fragmentShader);
+		if (I != m_fragment_shader_cache.end() && is_pending(&I->second))
+			return 0;
 		if (I != m_fragment_shader_cache.end())
 			return I->second.FragmentConstantOffsetCache.size() * 4 * sizeof(float);
 		LOG_ERROR(RSX, "Can't retrieve constant offset cache");
@@ -308,7 +738,7 @@ public:
 	void fill_fragment_constants_buffer(gsl::span<f32, gsl::dynamic_range> dst_buffer, const RSXFragmentProgram &fragment_program) const
 	{
 		const auto I = m_fragment_shader_cache.find(fragment_program);
-		if (I == m_fragment_shader_cache.end())
+		if (I == m_fragment_shader_cache.end() || is_pending(&I->second))
 			return;
 
 		verify(HERE), (dst_buffer.size_bytes() >= ::narrow<int>(I->second.FragmentConstantOffsetCache.size()) * 16);
@@ -356,6 +786,8 @@ public:
 
 	void clear()
 	{
+		// Pending jobs reference the program caches
+		process_async_jobs(true);
 		m_storage.clear();
 	}
 };
@@ -42,13 +42,16 @@ struct copy_unmodified_block_swizzled
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 width_in_block, u16 row_count, u16 depth, u32 dst_pitch_in_block)
 	{
-		std::unique_ptr<U[]> temp_swizzled(new U[width_in_block * row_count]);
+		static_assert(sizeof(T) == sizeof(U), "Type size doesn't match.");
+
+		if (!width_in_block || !row_count)
+			return;
+
 		for (int d = 0; d < depth; ++d)
 		{
-			rsx::convert_linear_swizzle<U>((void*)src.subspan(d * width_in_block * row_count).data(), temp_swizzled.get(), width_in_block, row_count, true);
-			gsl::span<const U> swizzled_src{ temp_swizzled.get(), ::narrow<int>(width_in_block * row_count) };
-			for (int row = 0; row < row_count; ++row)
-				copy(dst.subspan((row + d * row_count) * dst_pitch_in_block, width_in_block), swizzled_src.subspan(row * width_in_block, width_in_block));
+			const U* src_slice = src.data() + d * width_in_block * row_count;
+			T* dst_slice = dst.subspan(d * row_count * dst_pitch_in_block, (row_count - 1) * dst_pitch_in_block + width_in_block).data();
+			rsx::convert_swizzled_to_linear(dst_slice, src_slice, width_in_block, row_count, dst_pitch_in_block);
 		}
 	}
 };
@@ -5,6 +5,7 @@
 #include "TextureUtils.h"
 
 #include <atomic>
+#include <map>
 
 extern u64 get_system_time();
 
@@ -329,7 +330,8 @@ namespace rsx
 		};
 
 		shared_mutex m_cache_mutex;
-		std::unordered_map<u32, ranged_storage> m_cache;
+		std::map<u32, ranged_storage> m_cache; //Sections bucketed by the block containing their base address, ordered for range queries
+		u32 m_max_section_span = 0; //Largest distance from a block base to the end of a section stored in it
 		std::unordered_multimap<u32, std::pair<deferred_subresource, image_view_type>> m_temporary_subresource_cache;
 
 		std::atomic<u64> m_cache_update_tag = {0};
@@ -371,34 +373,37 @@ namespace rsx
 		virtual void insert_texture_barrier(commandbuffer_type&, image_storage_type* tex) = 0;
 		virtual image_view_type generate_cubemap_from_images(commandbuffer_type&, u32 gcm_format, u16 size, const std::array<image_resource_type, 6>& sources) = 0;
 
-		constexpr u32 get_block_size() const { return 0x1000000; }
-		inline u32 get_block_address(u32 address) const { return (address & ~0xFFFFFF); }
+		constexpr u32 get_block_size() const { return 0x100000; }
+		inline u32 get_block_address(u32 address) const { return (address & ~0xFFFFF); }
 
 		inline void update_cache_tag()
 		{
 			m_cache_update_tag++;
 		}
 
+		//Get the blocks which may hold sections intersecting [start, limit)
+		std::pair<typename std::map<u32, ranged_storage>::iterator, typename std::map<u32, ranged_storage>::iterator> get_block_range(u32 start, u32 limit)
+		{
+			if (start >= limit)
+			{
+				//Empty or wrapping range, test everything
+				return{ m_cache.begin(), m_cache.end() };
+			}
+
+			//Sections are stored in the block of their base address, so preceding blocks within the largest span may reach into the range
+			const u32 first_block = start > m_max_section_span ? get_block_address(start - m_max_section_span) : 0;
+			return{ m_cache.lower_bound(first_block), m_cache.lower_bound(limit) };
+		}
+
 	private:
 		//Internal implementation methods and helpers
 
 		std::pair<utils::protection, section_storage_type*> get_memory_protection(u32 address)
 		{
-			auto found = m_cache.find(get_block_address(address));
-			if (found != m_cache.end())
+			const auto blocks = get_block_range(address, address + 1);
+			for (auto It = blocks.first; It != blocks.second; It++)
 			{
-				for (auto &tex : found->second.data)
-				{
-					if (tex.is_locked() && tex.overlaps(address, false))
-						return{ tex.get_protection(), &tex };
-				}
-			}
-
-			//Get the preceding block and check if any hits are found
-			found = m_cache.find(get_block_address(address) - get_block_size());
-			if (found != m_cache.end())
-			{
-				for (auto &tex : found->second.data)
+				for (auto &tex : It->second.data)
 				{
 					if (tex.is_locked() && tex.overlaps(address, false))
 						return{ tex.get_protection(), &tex };
@@ -443,20 +448,28 @@ namespace rsx
 			std::pair<u32, u32> trampled_range = std::make_pair(address, address + range);
 			const bool strict_range_check = g_cfg.video.write_color_buffers || g_cfg.video.write_depth_buffer;
 
-			for (auto It = m_cache.begin(); It != m_cache.end(); It++)
+			auto blocks = get_block_range(trampled_range.first, trampled_range.second);
+
+			for (auto It = blocks.first; It != blocks.second;)
 			{
 				auto &range_data = It->second;
 				const u32 base = It->first;
 				bool range_reset = false;
 
 				if (base == last_dirty_block && range_data.valid_count == 0)
+				{
+					It++;
 					continue;
+				}
 
 				if (trampled_range.first <= trampled_range.second)
 				{
 					//Only if a valid range, ignore empty sets
 					if (trampled_range.first >= (range_data.max_addr + range_data.max_range) || range_data.min_addr >= trampled_range.second)
+					{
+						It++;
 						continue;
+					}
 				}
 
 				for (int i = 0; i < range_data.data.size(); i++)
@@ -485,9 +498,14 @@ namespace rsx
 
 				if (range_reset)
 				{
+					//Rescan the blocks covered by the grown range
 					last_dirty_block = base;
-					It = m_cache.begin();
+					blocks = get_block_range(trampled_range.first, trampled_range.second);
+					It = blocks.first;
+					continue;
 				}
+
+				It++;
 			}
 
 			return result;
@@ -721,9 +739,11 @@ namespace rsx
 		{
 			std::vector<section_storage_type*> results;
 			auto test = std::make_pair(rsx_address, range);
-			for (auto &address_range : m_cache)
+			const auto blocks = get_block_range(rsx_address, rsx_address + range);
+
+			for (auto It = blocks.first; It != blocks.second; It++)
 			{
-				auto &range_data = address_range.second;
+				auto &range_data = It->second;
 				if (!range_data.overlaps(rsx_address, range)) continue;
 
 				for (auto &tex : range_data.data)
@@ -760,6 +780,7 @@ namespace rsx
 		section_storage_type& find_cached_texture(u32 rsx_address, u32 rsx_size, bool confirm_dimensions = false, u16 width = 0, u16 height = 0, u16 depth = 0, u16 mipmaps = 0)
 		{
 			const u32 block_address = get_block_address(rsx_address);
+			m_max_section_span = std::max(m_max_section_span, align(rsx_address + rsx_size, 4096u) - block_address);
 
 			auto found = m_cache.find(block_address);
 			if (found != m_cache.end())
@@ -948,6 +969,26 @@ namespace rsx
 			return false;
 		}
 
+		bool is_range_locked(u32 address, u32 range)
+		{
+			if (!region_intersects_cache(address, range, true))
+				return false;
+
+			reader_lock lock(m_cache_mutex);
+
+			const auto blocks = get_block_range(address, address + range);
+			for (auto It = blocks.first; It != blocks.second; It++)
+			{
+				for (auto &tex : It->second.data)
+				{
+					if (tex.is_locked() && tex.overlaps(std::make_pair(address, range)))
+						return true;
+				}
+			}
+
+			return false;
+		}
+
 		std::tuple<bool, section_storage_type*> address_is_flushable(u32 address)
 		{
 			if (address < no_access_range.first ||
@@ -970,16 +1011,18 @@ namespace rsx
 				}
 			}
 
-			for (auto &address_range : m_cache)
+			const auto blocks = get_block_range(address, address + 1);
+
+			for (auto It = blocks.first; It != blocks.second; It++)
 			{
-				if (address_range.first == address)
+				if (It->first == get_block_address(address))
 					continue;
 
-				auto &range_data = address_range.second;
+				auto &range_data = It->second;
 
 				//Quickly discard range
-				const u32 lock_base = address_range.first & ~0xfff;
-				const u32 lock_limit = align(range_data.max_range + address_range.first, 4096);
+				const u32 lock_base = range_data.min_addr;
+				const u32 lock_limit = range_data.max_addr + range_data.max_range;
 
 				if (address < lock_base || address >= lock_limit)
 					continue;
@@ -26,6 +26,7 @@ GLGSRender::GLGSRender() : GSRender()
 {
 	m_shaders_cache.reset(new gl::shader_cache(m_prog_buffer, "opengl", "v1.1"));
 
+	//The strict vertex cache is created along with its heap in on_init_thread
 	if (g_cfg.video.disable_vertex_cache)
 		m_vertex_cache.reset(new gl::null_vertex_cache());
 	else
@@ -275,11 +276,27 @@ void GLGSRender::end()
 	std::chrono::time_point<steady_clock> program_start = steady_clock::now();
 	//Load program here since it is dependent on vertex state
 
-	load_program(upload_info);
+	const bool program_ready = load_program(upload_info);
 
 	std::chrono::time_point<steady_clock> program_stop = steady_clock::now();
 	m_begin_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(program_stop - program_start).count();
 
+	//Vertex data copied by the upload workers has to land before the buffers are unmapped or drawn from
+	wait_for_vertex_upload();
+
+	if (!program_ready)
+	{
+		//Program is still being compiled, skip the draw
+		if (manually_flush_ring_buffers)
+		{
+			m_attrib_ring_buffer->unmap();
+			m_index_ring_buffer->unmap();
+		}
+
+		rsx::thread::end();
+		return;
+	}
+
 	if (manually_flush_ring_buffers)
 	{
 		m_attrib_ring_buffer->unmap();
@@ -721,6 +738,12 @@ void GLGSRender::on_init_thread()
 		LOG_WARNING(RSX, "Using legacy openGL buffers.");
 		manually_flush_ring_buffers = true;
 
+		if (g_cfg.video.strict_vertex_cache && !g_cfg.video.disable_vertex_cache)
+		{
+			//The strict vertex cache requires a persistently mapped heap
+			LOG_WARNING(RSX, "Strict vertex cache is not supported with legacy openGL buffers.");
+		}
+
 		m_attrib_ring_buffer.reset(new gl::legacy_ring_buffer());
 		m_transform_constants_buffer.reset(new gl::legacy_ring_buffer());
 		m_fragment_constants_buffer.reset(new gl::legacy_ring_buffer());
@@ -734,6 +757,13 @@ void GLGSRender::on_init_thread()
 		m_fragment_constants_buffer.reset(new gl::ring_buffer());
 		m_vertex_state_buffer.reset(new gl::ring_buffer());
 		m_index_ring_buffer.reset(new gl::ring_buffer());
+
+		if (g_cfg.video.strict_vertex_cache && !g_cfg.video.disable_vertex_cache)
+		{
+			m_vertex_cache_heap.reset(new gl::ring_buffer());
+			m_vertex_cache_heap->create(gl::buffer::target::texture, std::min<GLsizeiptr>(m_max_texbuffer_size, 64 * 0x100000));
+			m_vertex_cache.reset(new gl::strict_vertex_cache([this](u32 address, u32 range) { return m_gl_texture_cache.is_range_locked(address, range); }, (u32)m_vertex_cache_heap->size()));
+		}
 	}
 
 	m_attrib_ring_buffer->create(gl::buffer::target::texture, std::min<GLsizeiptr>(m_max_texbuffer_size, 256 * 0x100000));
@@ -912,6 +942,19 @@ void GLGSRender::on_exit()
 	}
 
 	m_text_printer.close();
+	m_vertex_cache->purge();
+
+	for (auto &fence : m_vertex_cache_frame_fences)
+	{
+		fence.second.destroy();
+	}
+
+	m_vertex_cache_frame_fences.clear();
+
+	if (m_vertex_cache_heap)
+	{
+		m_vertex_cache_heap->remove();
+	}
 	m_gl_texture_cache.destroy();
 	m_depth_converter.destroy();
 	m_ui_renderer.destroy();
@@ -1034,7 +1077,7 @@ bool GLGSRender::check_program_state()
 	return (rsx::method_registers.shader_program_address() != 0);
 }
 
-void GLGSRender::load_program(const vertex_upload_info& upload_info)
+bool GLGSRender::load_program(const vertex_upload_info& upload_info)
 {
 	get_current_fragment_program(fs_sampler_state);
 	verify(HERE), current_fragment_program.valid;
@@ -1044,12 +1087,49 @@ void GLGSRender::load_program(const vertex_upload_info& upload_info)
 	auto &fragment_program = current_fragment_program;
 	auto &vertex_program = current_vertex_program;
 
+	//The input layout is needed up front to select a layout specialized vertex program
+	s32 vertex_layout_state[64];
+	fill_vertex_layout_state(m_vertex_layout, upload_info.allocated_vertex_count, vertex_layout_state, upload_info.persistent_mapping_offset, upload_info.volatile_mapping_offset);
+
 	vertex_program.skip_vertex_input_check = true;	//not needed for us since decoding is done server side
+	vertex_program.fetch_layout.set(vertex_layout_state, g_cfg.video.specialized_vertex_fetch);
 	fragment_program.unnormalized_coords = 0; //unused
 	void* pipeline_properties = nullptr;
 
-	m_program = &m_prog_buffer.getGraphicPipelineState(vertex_program, fragment_program, pipeline_properties);
-	m_program->use();
+	bool program_ready = true;
+	bool use_previous_program = false;
+
+	rsx_vertex_fetch_layout input_layout;
+	input_layout.set(vertex_layout_state, true);
+
+	if (g_cfg.video.async_shader_compilation)
+	{
+		if (auto program = m_prog_buffer.get_graphics_pipeline_async(vertex_program, fragment_program, pipeline_properties))
+		{
+			m_program = program;
+		}
+		else
+		{
+			//Keep the previous program bound if allowed and if it reads the same vertex input
+			//Its fragment constants are read from its own ucode, which must still be present
+			//NOTE: Topology is not part of GL program state
+			use_previous_program = m_program && g_cfg.video.async_shader_fallback &&
+				m_program_input_layout == input_layout &&
+				m_prog_buffer.is_fragment_program_ready(m_program_fragment_program);
+
+			program_ready = use_previous_program;
+		}
+	}
+	else
+	{
+		m_program = &m_prog_buffer.getGraphicPipelineState(vertex_program, fragment_program, pipeline_properties);
+	}
+
+	if (program_ready && !use_previous_program)
+	{
+		m_program_fragment_program = fragment_program;
+		m_program_input_layout = input_layout;
+	}
 
 	if (m_prog_buffer.check_cache_missed())
 	{
@@ -1068,12 +1148,22 @@ void GLGSRender::load_program(const vertex_upload_info& upload_info)
 		}
 	}
 
+	if (!program_ready)
+	{
+		return false;
+	}
+
+	m_program->use();
+
 	u8 *buf;
 	u32 vertex_state_offset;
 	u32 vertex_constants_offset;
 	u32 fragment_constants_offset;
 
-	const u32 fragment_constants_size = (const u32)m_prog_buffer.get_fragment_constants_buffer_size(fragment_program);
+	//Fragment constants layout belongs to the bound program
+	const auto& bound_fragment_program = use_previous_program ? m_program_fragment_program : fragment_program;
+
+	const u32 fragment_constants_size = (const u32)m_prog_buffer.get_fragment_constants_buffer_size(bound_fragment_program);
 	const u32 fragment_buffer_size = fragment_constants_size + (18 * 4 * sizeof(float));
 
 	if (manually_flush_ring_buffers)
@@ -1094,7 +1184,7 @@ void GLGSRender::load_program(const vertex_upload_info& upload_info)
 	*(reinterpret_cast<f32*>(buf + 136)) = rsx::method_registers.point_size();
 	*(reinterpret_cast<f32*>(buf + 140)) = rsx::method_registers.clip_min();
 	*(reinterpret_cast<f32*>(buf + 144)) = rsx::method_registers.clip_max();
-	fill_vertex_layout_state(m_vertex_layout, upload_info.allocated_vertex_count, reinterpret_cast<s32*>(buf + 160), upload_info.persistent_mapping_offset, upload_info.volatile_mapping_offset);
+	memcpy(buf + 160, vertex_layout_state, sizeof(vertex_layout_state));
 
 	if (m_transform_constants_dirty)
 	{
@@ -1110,7 +1200,7 @@ void GLGSRender::load_program(const vertex_upload_info& upload_info)
 	buf = static_cast<u8*>(mapping.first);
 	fragment_constants_offset = mapping.second;
 	if (fragment_constants_size)
-		m_prog_buffer.fill_fragment_constants_buffer({ reinterpret_cast<float*>(buf), gsl::narrow<int>(fragment_constants_size) }, fragment_program);
+		m_prog_buffer.fill_fragment_constants_buffer({ reinterpret_cast<float*>(buf), gsl::narrow<int>(fragment_constants_size) }, bound_fragment_program);
 
 	// Fragment state
 	fill_fragment_state_buffer(buf+fragment_constants_size, fragment_program);
@@ -1129,6 +1219,7 @@ void GLGSRender::load_program(const vertex_upload_info& upload_info)
 	}
 
 	m_transform_constants_dirty = false;
+	return true;
 }
 
 void GLGSRender::update_draw_state()
@@ -1387,7 +1478,22 @@ void GLGSRender::flip(int buffer)
 	m_gl_texture_cache.on_frame_end();
 
 	m_rtts.free_invalidated();
-	m_vertex_cache->purge();
+
+	if (m_vertex_cache->has_own_heap())
+	{
+		//Vertex cache heap space released during a frame is reused once the GPU has completed it
+		m_vertex_cache_frame_fences.emplace_back(m_vertex_cache->get_frame_id(), gl::fence{});
+		m_vertex_cache_frame_fences.back().second.create();
+
+		while (!m_vertex_cache_frame_fences.empty() && m_vertex_cache_frame_fences.front().second.check_signaled())
+		{
+			m_vertex_cache->on_frame_retired(m_vertex_cache_frame_fences.front().first);
+			m_vertex_cache_frame_fences.front().second.destroy();
+			m_vertex_cache_frame_fences.pop_front();
+		}
+	}
+
+	m_vertex_cache->on_frame_end();
 
 	//If we are skipping the next frame, do not reset perf counters
 	if (skip_frame) return;
@@ -1409,11 +1515,14 @@ u64 GLGSRender::timestamp() const
 
 bool GLGSRender::on_access_violation(u32 address, bool is_writing)
 {
+	//Vertex cache goes first, texture cache may restore protection of shared pages
+	const bool vertex_cache_handled = is_writing && m_vertex_cache->invalidate_range(address, 1, true);
+
 	bool can_flush = (std::this_thread::get_id() == m_thread_id);
 	auto result = m_gl_texture_cache.invalidate_address(address, is_writing, can_flush);
 
 	if (!result.violation_handled)
-		return false;
+		return vertex_cache_handled;
 
 	{
 		std::lock_guard<std::mutex> lock(m_sampler_mutex);
@@ -1439,6 +1548,9 @@ bool GLGSRender::on_access_violation(u32 address, bool is_writing)
 
 void GLGSRender::on_notify_memory_unmapped(u32 address_base, u32 size)
 {
+	//Memory is already unmapped, drop ranges without touching protection
+	m_vertex_cache->invalidate_range(address_base, size, false);
+
 	//Discard all memory in that range without bothering with writeback (Force it for strict?)
 	if (m_gl_texture_cache.invalidate_range(address_base, size, true, true, false).violation_handled)
 	{
@@ -18,6 +18,7 @@ namespace gl
 {
 	using vertex_cache = rsx::vertex_cache::default_vertex_cache<rsx::vertex_cache::uploaded_range<GLenum>, GLenum>;
 	using weak_vertex_cache = rsx::vertex_cache::weak_vertex_cache<GLenum>;
+	using strict_vertex_cache = rsx::vertex_cache::strict_vertex_cache<GLenum>;
 	using null_vertex_cache = vertex_cache;
 
 	using shader_cache = rsx::shaders_cache<void*, GLProgramBuffer>;
@@ -262,6 +263,7 @@ struct vertex_upload_info
 	u32 vertex_index_base;
 	u32 persistent_mapping_offset;
 	u32 volatile_mapping_offset;
+	bool persistent_in_cache_heap; //Persistent data is read from the vertex cache heap
 	std::optional<std::tuple<GLenum, u32> > index_info;
 };
 
@@ -273,7 +275,9 @@ private:
 
 	gl::sampler_state m_gl_sampler_states[rsx::limits::fragment_textures_count];
 
-	gl::glsl::program *m_program;
+	gl::glsl::program *m_program = nullptr;
+	RSXFragmentProgram m_program_fragment_program = {}; //Fragment program the bound program was built from
+	rsx_vertex_fetch_layout m_program_input_layout = {}; //Vertex input formats the bound program was last used with
 
 	gl_render_targets m_rtts;
 
@@ -287,6 +291,10 @@ private:
 	std::unique_ptr<gl::ring_buffer> m_transform_constants_buffer;
 	std::unique_ptr<gl::ring_buffer> m_vertex_state_buffer;
 	std::unique_ptr<gl::ring_buffer> m_index_ring_buffer;
+	std::unique_ptr<gl::ring_buffer> m_vertex_cache_heap; //Persistent storage of the strict vertex cache, not used as a ring
+
+	bool m_persistent_stream_from_cache = false; //Persistent stream buffer is bound to the vertex cache heap
+	std::deque<std::pair<u64, gl::fence>> m_vertex_cache_frame_fences; //Vertex cache frames still in use by the GPU
 
 	u32 m_draw_calls = 0;
 	s64 m_begin_time = 0;
@@ -347,7 +355,7 @@ private:
 	void init_buffers(rsx::framebuffer_creation_context context, bool skip_reading = false);
 
 	bool check_program_state();
-	void load_program(const vertex_upload_info& upload_info);
+	bool load_program(const vertex_upload_info& upload_info);
 
 	void update_draw_state();
 
@@ -920,6 +920,12 @@ namespace gl
 
 		virtual void unmap() {}
 
+		//Direct access to the persistent mapping, for storage not allocated as a ring
+		void* get_mapping(u32 offset) const
+		{
+			return (char*)m_memory_mapping + offset;
+		}
+
 		void bind_range(u32 index, u32 offset, u32 size) const
 		{
 			glBindBufferRange((GLenum)current_target(), index, id(), offset, size);
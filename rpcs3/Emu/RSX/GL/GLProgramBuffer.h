@@ -10,20 +10,47 @@ struct GLTraits
 	using pipeline_storage_type = gl::glsl::program;
 	using pipeline_properties = void*;
 
+	// Shader objects can only be created on the thread owning the GL context
+	static constexpr bool threadsafe_compile = false;
+
 	static
-	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t /*ID*/)
+	void decompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t /*ID*/)
 	{
 		fragmentProgramData.Decompile(RSXFP);
+	}
+
+	static
+	void compile_fragment_program(fragment_program_type& fragmentProgramData)
+	{
 		fragmentProgramData.Compile();
 	}
 
 	static
-	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t /*ID*/)
+	void decompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t /*ID*/)
 	{
 		vertexProgramData.Decompile(RSXVP);
+	}
+
+	static
+	void compile_vertex_program(vertex_program_type& vertexProgramData)
+	{
 		vertexProgramData.Compile();
 	}
 
+	static
+	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
+	{
+		decompile_fragment_program(RSXFP, fragmentProgramData, ID);
+		compile_fragment_program(fragmentProgramData);
+	}
+
+	static
+	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
+	{
+		decompile_vertex_program(RSXVP, vertexProgramData, ID);
+		compile_vertex_program(vertexProgramData);
+	}
+
 	static
 	pipeline_storage_type build_pipeline(const vertex_program_type &vertexProgramData, const fragment_program_type &fragmentProgramData, const pipeline_properties&)
 	{
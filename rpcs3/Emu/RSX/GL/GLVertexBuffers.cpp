@@ -196,17 +196,19 @@ vertex_upload_info GLGSRender::set_vertex_buffer()
 	auto required = calculate_memory_requirements(m_vertex_layout, vertex_count);
 
 	std::pair<void*, u32> persistent_mapping = {}, volatile_mapping = {};
-	vertex_upload_info upload_info = { result.vertex_draw_count, result.allocated_vertex_count, result.vertex_index_base, 0u, 0u, result.index_info };
+	vertex_upload_info upload_info = { result.vertex_draw_count, result.allocated_vertex_count, result.vertex_index_base, 0u, 0u, false, result.index_info };
 
 	if (required.first > 0)
 	{
 		//Check if cacheable
 		//Only data in the 'persistent' block may be cached
-		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
+		//The strict vertex cache keeps this data beyond frame boundaries in its own heap
 		bool in_cache = false;
 		bool to_store = false;
 		u32  storage_address = UINT32_MAX;
 
+		const bool own_heap = m_vertex_cache->has_own_heap();
+
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
@@ -215,6 +217,7 @@ vertex_upload_info GLGSRender::set_vertex_buffer()
 			{
 				in_cache = true;
 				upload_info.persistent_mapping_offset = cached->offset_in_heap;
+				upload_info.persistent_in_cache_heap = own_heap;
 			}
 			else
 			{
@@ -222,12 +225,27 @@ vertex_upload_info GLGSRender::set_vertex_buffer()
 			}
 		}
 
+		if (!in_cache && to_store && own_heap)
+		{
+			const u32 cache_offset = m_vertex_cache->allocate_range(storage_address, GL_R8UI, required.first);
+
+			if (cache_offset != UINT32_MAX)
+			{
+				//Written directly into the cache heap below
+				in_cache = true;
+				persistent_mapping = { m_vertex_cache_heap->get_mapping(cache_offset), cache_offset };
+				upload_info.persistent_mapping_offset = cache_offset;
+				upload_info.persistent_in_cache_heap = true;
+			}
+		}
+
 		if (!in_cache)
 		{
 			persistent_mapping = m_attrib_ring_buffer->alloc_from_heap(required.first, m_min_texbuffer_alignment);
 			upload_info.persistent_mapping_offset = persistent_mapping.second;
+			m_vertex_cache->invalidate_heap_range(persistent_mapping.second, required.first);
 
-			if (to_store)
+			if (to_store && !own_heap)
 			{
 				//store ref in vertex cache
 				m_vertex_cache->store_range(storage_address, GL_R8UI, required.first, persistent_mapping.second);
@@ -238,12 +256,24 @@ vertex_upload_info GLGSRender::set_vertex_buffer()
 	if (required.second > 0)
 	{
 		volatile_mapping = m_attrib_ring_buffer->alloc_from_heap(required.second, m_min_texbuffer_alignment);
+		m_vertex_cache->invalidate_heap_range(volatile_mapping.second, required.second);
 		upload_info.volatile_mapping_offset = volatile_mapping.second;
 	}
 
 	//Write all the data
 	write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping.first, volatile_mapping.first);
 
+	if (upload_info.persistent_in_cache_heap != m_persistent_stream_from_cache)
+	{
+		//Point the persistent stream at the heap holding the data
+		m_persistent_stream_from_cache = upload_info.persistent_in_cache_heap;
+
+		if (m_persistent_stream_from_cache)
+			m_gl_persistent_stream_buffer.copy_from(*m_vertex_cache_heap, GL_R8UI, 0, (u32)m_vertex_cache_heap->size());
+		else
+			m_gl_persistent_stream_buffer.copy_from(*m_attrib_ring_buffer, GL_R8UI, 0, (u32)m_attrib_ring_buffer->size());
+	}
+
 	std::chrono::time_point<steady_clock> now = steady_clock::now();
 	m_vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
 	return upload_info;
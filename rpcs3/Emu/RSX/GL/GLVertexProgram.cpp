@@ -150,7 +150,7 @@ void GLVertexDecompilerThread::insertOutputs(std::stringstream & OS, const std::
 void GLVertexDecompilerThread::insertMainStart(std::stringstream & OS)
 {
 	insert_glsl_legacy_function(OS, glsl::glsl_vertex_program, properties.has_lit_op);
-	glsl::insert_vertex_input_fetch(OS, glsl::glsl_rules_opengl4, gl::get_driver_caps().vendor_INTEL==false);
+	glsl::insert_vertex_input_fetch(OS, glsl::glsl_rules_opengl4, gl::get_driver_caps().vendor_INTEL==false, &rsx_vertex_program.fetch_layout);
 
 	std::string parameters = "";
 	for (int i = 0; i < 16; ++i)
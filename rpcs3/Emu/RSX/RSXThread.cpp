@@ -29,6 +29,7 @@ rsx::frame_capture_data frame_debug;
 namespace rsx
 {
 	std::function<bool(u32 addr, bool is_writing)> g_access_violation_handler;
+	std::function<void(u32 base, u32 length)> g_on_section_unprotect;
 
 	//TODO: Restore a working shaders cache
 
@@ -360,6 +361,30 @@ namespace rsx
 		}
 	}
 
+	namespace
+	{
+		//Copy FIFO arguments to host memory, converting them from big endian
+		void read_fifo_args(u32* dst, const be_t<u32>* src, u32 count)
+		{
+			const __m128i* src_vec = reinterpret_cast<const __m128i*>(src);
+			__m128i* dst_vec = reinterpret_cast<__m128i*>(dst);
+			u32 i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				//Swap bytes within each halfword, then swap the halfwords
+				const __m128i value = _mm_loadu_si128(src_vec++);
+				const __m128i swapped = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+				_mm_storeu_si128(dst_vec++, _mm_shufflehi_epi16(_mm_shufflelo_epi16(swapped, 0xB1), 0xB1));
+			}
+
+			for (; i < count; i++)
+			{
+				dst[i] = src[i];
+			}
+		}
+	}
+
 	void thread::on_task()
 	{
 		on_init_thread();
@@ -491,6 +516,32 @@ namespace rsx
 			has_deferred_call = false;
 		};
 
+		//Last IO mapping used by the FIFO, avoids walking the mapping table for every command
+		u32 io_cache_revision = UINT32_MAX;
+		u32 io_cache_start = 0;
+		u32 io_cache_size = 0;
+		u32 io_cache_real = 0;
+
+		auto get_fifo_address = [&](u32 io_address) -> u32
+		{
+			const u32 revision = RSXIOMem.GetRevision();
+
+			if (revision != io_cache_revision || (io_address - io_cache_start) >= io_cache_size)
+			{
+				if (!RSXIOMem.getMappedRange(io_address, io_cache_start, io_cache_size, io_cache_real))
+				{
+					io_cache_revision = UINT32_MAX;
+					return RSXIOMem.RealAddr(io_address);
+				}
+
+				io_cache_revision = revision;
+			}
+
+			return io_cache_real + (io_address - io_cache_start);
+		};
+
+		alignas(16) u32 fifo_args[0x800];
+
 		// TODO: exit condition
 		while (!Emu.IsStopped())
 		{
@@ -535,7 +586,7 @@ namespace rsx
 
 			//Validate put and get registers
 			//TODO: Who should handle graphics exceptions??
-			const u32 get_address = RSXIOMem.RealAddr(internal_get);
+			const u32 get_address = get_fifo_address(internal_get);
 
 			if (!get_address)
 			{
@@ -556,7 +607,7 @@ namespace rsx
 				continue;
 			}
 
-			const u32 cmd = ReadIO32(internal_get);
+			const u32 cmd = vm::read32(get_address);
 			const u32 count = (cmd >> 18) & 0x7ff;
 
 			if ((cmd & RSX_METHOD_OLD_JUMP_CMD_MASK) == RSX_METHOD_OLD_JUMP_CMD)
@@ -603,7 +654,7 @@ namespace rsx
 			}
 
 			//Validate the args ptr if the command attempts to read from it
-			const u32 args_address = RSXIOMem.RealAddr(internal_get + 4);
+			const u32 args_address = get_fifo_address(internal_get + 4);
 
 			if (!args_address && count)
 			{
@@ -627,7 +678,11 @@ namespace rsx
 			// All good on valid memory ptrs
 			mem_faults_count = 0;
 
-			auto args = vm::ptr<u32>::make(args_address);
+			if (count)
+			{
+				read_fifo_args(fifo_args, vm::_ptr<const u32>(args_address), count);
+			}
+
 			invalid_command_interrupt_raised = false;
 			bool unaligned_command = false;
 
@@ -644,10 +699,30 @@ namespace rsx
 			if (internal_get < put && ((internal_get + (count + 1) * 4) > put))
 				LOG_ERROR(RSX, "Get pointer jumping over put pointer! This is bad!");
 
+			const bool non_increment = (cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD;
+
 			for (u32 i = 0; i < count; i++)
 			{
-				u32 reg = ((cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? first_cmd : first_cmd + i;
-				u32 value = args[i];
+				u32 reg = non_increment ? first_cmd : first_cmd + i;
+				u32 value = fifo_args[i];
+
+				//Registers without a handler only latch state; unless a deferred draw needs flushing, write them in one go
+				if (!has_deferred_call && !capture_current_frame && reg < methods.size() && !methods[reg])
+				{
+					if (non_increment)
+					{
+						method_registers.decode(reg, fifo_args[count - 1]);
+						break;
+					}
+
+					u32 run = 1;
+					while (i + run < count && reg + run < methods.size() && !methods[reg + run])
+						run++;
+
+					method_registers.decode(reg, fifo_args + i, run);
+					i += run - 1;
+					continue;
+				}
 
 				bool execute_method_call = true;
 
@@ -802,6 +877,8 @@ namespace rsx
 			m_vblank_thread->join();
 			m_vblank_thread.reset();
 		}
+
+		m_vertex_upload_queue.stop();
 	}
 
 	std::string thread::get_name() const
@@ -1190,6 +1267,7 @@ namespace rsx
 		const u32 transform_program_start = rsx::method_registers.transform_program_start();
 		current_vertex_program.output_mask = rsx::method_registers.vertex_attrib_output_mask();
 		current_vertex_program.skip_vertex_input_check = false;
+		current_vertex_program.fetch_layout.set(nullptr, false);
 
 		current_vertex_program.rsx_vertex_inputs.resize(0);
 		current_vertex_program.data.resize((512 - transform_program_start) * 4);
@@ -2007,12 +2085,127 @@ namespace rsx
 				}
 
 				const u32 data_size = block.attribute_stride * unique_verts;
-				memcpy(persistent, (char*)vm::base(block.real_offset_address) + vertex_base, data_size);
+				const char* src = (char*)vm::base(block.real_offset_address) + vertex_base;
+
+				if (g_cfg.video.vertex_upload_threads && data_size >= vertex_upload_queue::min_async_size)
+					m_vertex_upload_queue.enqueue(persistent, src, data_size);
+				else
+					memcpy(persistent, src, data_size);
+
 				persistent += data_size;
 			}
 		}
 	}
 
+	void thread::wait_for_vertex_upload()
+	{
+		while (m_vertex_upload_queue.help())
+		{
+			//Workers can be blocked in the access violation handler until this thread services their flush request
+			do_local_task(false);
+			std::this_thread::yield();
+		}
+	}
+
+	vertex_upload_queue::~vertex_upload_queue()
+	{
+		stop();
+	}
+
+	void vertex_upload_queue::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_exit = true;
+		}
+
+		m_cv.notify_all();
+
+		for (auto& thread : m_threads)
+		{
+			thread->join();
+		}
+
+		m_threads.clear();
+	}
+
+	void vertex_upload_queue::enqueue(void* dst, const void* src, u32 size)
+	{
+		if (m_threads.empty())
+		{
+			const u32 thread_count = g_cfg.video.vertex_upload_threads;
+
+			for (u32 i = 0; i < thread_count; i++)
+			{
+				m_threads.emplace_back();
+
+				thread_ctrl::spawn(m_threads.back(), fmt::format("Vertex Upload Thread %u", i), [this]()
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+
+					while (true)
+					{
+						m_cv.wait(lock, [this]() { return m_exit || !m_jobs.empty(); });
+
+						if (m_exit)
+						{
+							break;
+						}
+
+						const copy_job job = m_jobs.front();
+						m_jobs.pop_front();
+
+						lock.unlock();
+						run(job);
+						lock.lock();
+					}
+				});
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (u32 offset = 0; offset < size; offset += chunk_size)
+			{
+				const u32 length = std::min<u32>(size - offset, +chunk_size);
+				m_jobs.push_back({ static_cast<char*>(dst) + offset, static_cast<const char*>(src) + offset, length });
+				m_pending++;
+			}
+		}
+
+		m_cv.notify_all();
+	}
+
+	void vertex_upload_queue::run(const copy_job& job)
+	{
+		std::memcpy(job.dst, job.src, job.size);
+		m_pending--;
+	}
+
+	bool vertex_upload_queue::help()
+	{
+		while (true)
+		{
+			copy_job job;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				if (m_jobs.empty())
+				{
+					break;
+				}
+
+				job = m_jobs.front();
+				m_jobs.pop_front();
+			}
+
+			run(job);
+		}
+
+		return busy();
+	}
+
 	void thread::flip(int buffer)
 	{
 		if (g_cfg.video.frame_skip_enabled)
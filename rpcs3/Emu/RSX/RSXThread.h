@@ -5,6 +5,8 @@
 #include <set>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 #include "GCM.h"
 #include "rsx_cache.h"
 #include "RSXTexture.h"
@@ -216,6 +218,51 @@ namespace rsx
 		}
 	};
 
+	/**
+	 * Copies large vertex blocks into mapped upload memory on worker threads.
+	 * The render thread must wait for completion before the memory is unmapped or read by the GPU.
+	 * Workers are named threads so that faults on pages protected by the texture cache reach the access violation handler.
+	 */
+	class vertex_upload_queue
+	{
+		struct copy_job
+		{
+			void* dst;
+			const void* src;
+			u32 size;
+		};
+
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		std::deque<copy_job> m_jobs;
+		std::vector<std::shared_ptr<thread_ctrl>> m_threads;
+		atomic_t<u32> m_pending{ 0 };
+		bool m_exit = false;
+
+		void run(const copy_job& job);
+
+	public:
+		//Blocks smaller than this are copied inline
+		static constexpr u32 min_async_size = 0x40000;
+		static constexpr u32 chunk_size = 0x10000;
+
+		vertex_upload_queue() = default;
+		~vertex_upload_queue();
+
+		void enqueue(void* dst, const void* src, u32 size);
+
+		//Joins the workers, must be called before the render thread exits
+		void stop();
+
+		//Runs queued copies on the calling thread, returns true if workers are still busy
+		bool help();
+
+		bool busy() const
+		{
+			return m_pending != 0;
+		}
+	};
+
 	struct sampled_image_descriptor_base;
 
 	class thread : public named_thread
@@ -423,6 +470,14 @@ namespace rsx
 		 */
 		void write_vertex_data_to_memory(const vertex_input_layout& layout, u32 first_vertex, u32 vertex_count, void *persistent_data, void *volatile_data);
 
+		/**
+		 * Waits for vertex blocks copied by the upload workers
+		 * Must be called before the output buffers are unmapped or the draw is submitted
+		 */
+		void wait_for_vertex_upload();
+
+		vertex_upload_queue m_vertex_upload_queue;
+
 	private:
 		std::mutex m_mtx_task;
 
@@ -223,10 +223,74 @@ struct rsx_vertex_input
 	}
 };
 
+/**
+ * Input formats baked into a vertex program with a specialized fetch routine.
+ * Offsets, strides and divisors are not part of the key and are still read from the vertex layout state.
+ */
+struct rsx_vertex_fetch_layout
+{
+	enum : u16
+	{
+		type_mask = 0x7,
+		size_shift = 3,
+		size_mask = 0x7 << size_shift,
+		swap_bytes = 1 << 6,
+		is_volatile = 1 << 7,
+		frequency_shift = 8,
+		frequency_mask = 0x3 << frequency_shift,
+		modulo = 1 << 10,
+		valid = 1 << 15
+	};
+
+	//One entry per input location, zero if the location reads default values
+	std::array<u16, 16> attributes;
+	bool specialized;
+
+	//Build from the 16 ivec4 descriptors written by fill_vertex_layout_state
+	void set(const s32* layout_state, bool specialize)
+	{
+		attributes = {};
+		specialized = specialize;
+
+		if (!specialize)
+			return;
+
+		for (u32 index = 0; index < 16; ++index)
+		{
+			const s32 type = layout_state[index * 4 + 0];
+			const s32 size = layout_state[index * 4 + 1];
+			const s32 flags = layout_state[index * 4 + 3];
+
+			if (size == 0)
+				continue;
+
+			u16 value = valid;
+			value |= (type & type_mask);
+			value |= (size << size_shift) & size_mask;
+			value |= (flags & (1 << 8)) ? swap_bytes : 0;
+			value |= (flags & (1 << 9)) ? is_volatile : 0;
+			value |= ((flags >> 10) << frequency_shift) & frequency_mask;
+			value |= (flags & (1 << 12)) ? modulo : 0;
+			attributes[index] = value;
+		}
+	}
+
+	bool operator==(const rsx_vertex_fetch_layout& other) const
+	{
+		return specialized == other.specialized && attributes == other.attributes;
+	}
+
+	bool operator!=(const rsx_vertex_fetch_layout& other) const
+	{
+		return !(*this == other);
+	}
+};
+
 struct RSXVertexProgram
 {
 	std::vector<u32> data;
 	std::vector<rsx_vertex_input> rsx_vertex_inputs;
 	u32 output_mask;
 	bool skip_vertex_input_check;
+	rsx_vertex_fetch_layout fetch_layout;
 };
@@ -588,6 +588,12 @@ VKGSRender::VKGSRender() : GSRender()
 	m_texture_upload_buffer_ring_info.init(VK_TEXTURE_UPLOAD_RING_BUFFER_SIZE_M * 0x100000, "texture upload buffer", 32 * 0x100000);
 	m_texture_upload_buffer_ring_info.heap.reset(new vk::buffer(*m_device, VK_TEXTURE_UPLOAD_RING_BUFFER_SIZE_M * 0x100000, m_memory_type_mapping.host_visible_coherent, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 0));
 
+	if (g_cfg.video.strict_vertex_cache && !g_cfg.video.disable_vertex_cache)
+	{
+		m_vertex_cache_heap.init(VK_VERTEX_CACHE_HEAP_SIZE_M * 0x100000, "vertex cache");
+		m_vertex_cache_heap.heap.reset(new vk::buffer(*m_device, VK_VERTEX_CACHE_HEAP_SIZE_M * 0x100000, m_memory_type_mapping.host_visible_coherent, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT, 0));
+	}
+
 	for (auto &ctx : frame_context_storage)
 	{
 		vkCreateSemaphore((*m_device), &semaphore_info, nullptr, &ctx.present_semaphore);
@@ -616,6 +622,8 @@ VKGSRender::VKGSRender() : GSRender()
 
 	if (g_cfg.video.disable_vertex_cache)
 		m_vertex_cache.reset(new vk::null_vertex_cache());
+	else if (g_cfg.video.strict_vertex_cache)
+		m_vertex_cache.reset(new vk::strict_vertex_cache([this](u32 address, u32 range) { return m_texture_cache.is_range_locked(address, range); }, VK_VERTEX_CACHE_HEAP_SIZE_M * 0x100000));
 	else
 		m_vertex_cache.reset(new vk::weak_vertex_cache());
 
@@ -659,6 +667,9 @@ VKGSRender::~VKGSRender()
 	//Wait for device to finish up with resources
 	vkDeviceWaitIdle(*m_device);
 
+	//Release protected vertex ranges
+	m_vertex_cache->purge();
+
 	//Texture cache
 	m_texture_cache.destroy();
 
@@ -674,6 +685,7 @@ VKGSRender::~VKGSRender()
 	m_uniform_buffer_ring_info.heap.reset();
 	m_attrib_ring_info.heap.reset();
 	m_texture_upload_buffer_ring_info.heap.reset();
+	m_vertex_cache_heap.heap.reset();
 
 	//Fallback bindables
 	null_buffer.reset();
@@ -764,6 +776,9 @@ VKGSRender::~VKGSRender()
 
 bool VKGSRender::on_access_violation(u32 address, bool is_writing)
 {
+	//Vertex cache goes first, texture cache may restore protection of shared pages
+	const bool vertex_cache_handled = is_writing && m_vertex_cache->invalidate_range(address, 1, true);
+
 	vk::texture_cache::thrashed_set result;
 	{
 		std::lock_guard<std::mutex> lock(m_secondary_cb_guard);
@@ -771,7 +786,7 @@ bool VKGSRender::on_access_violation(u32 address, bool is_writing)
 	}
 
 	if (!result.violation_handled)
-		return false;
+		return vertex_cache_handled;
 
 	{
 		std::lock_guard<std::mutex> lock(m_sampler_mutex);
@@ -843,6 +858,9 @@ bool VKGSRender::on_access_violation(u32 address, bool is_writing)
 
 void VKGSRender::on_notify_memory_unmapped(u32 address_base, u32 size)
 {
+	//Memory is already unmapped, drop ranges without touching protection
+	m_vertex_cache->invalidate_range(address_base, size, false);
+
 	std::lock_guard<std::mutex> lock(m_secondary_cb_guard);
 	if (m_texture_cache.invalidate_range(address_base, size, true, true, false,
 		m_secondary_command_buffer, m_memory_type_mapping, m_swapchain->get_graphics_queue()).violation_handled)
@@ -893,7 +911,10 @@ void VKGSRender::check_heap_status()
 		if (target_frame == nullptr)
 		{
 			flush_command_queue(true);
-			m_vertex_cache->purge();
+
+			//Ranges kept in the vertex cache heap are not affected
+			if (!m_vertex_cache->has_own_heap())
+				m_vertex_cache->purge();
 
 			m_index_buffer_ring_info.reset_allocation_stats();
 			m_uniform_buffer_ring_info.reset_allocation_stats();
@@ -1209,7 +1230,23 @@ void VKGSRender::end()
 
 	//Load program
 	std::chrono::time_point<steady_clock> program_start = textures_end;
-	load_program(std::get<2>(upload_info), std::get<3>(upload_info));
+	const bool program_ready = load_program(std::get<2>(upload_info), std::get<3>(upload_info));
+
+	//Vertex data copied by the upload workers has to land before the attribute heap is unmapped
+	wait_for_vertex_upload();
+
+	if (m_attrib_ring_info.mapped)
+		m_attrib_ring_info.unmap();
+
+	if (m_vertex_cache_heap.mapped)
+		m_vertex_cache_heap.unmap();
+
+	if (!program_ready)
+	{
+		//Pipeline is still being compiled, skip the draw
+		rsx::thread::end();
+		return;
+	}
 
 	m_program->bind_uniform(m_persistent_attribute_storage, "persistent_input_stream", m_current_frame->descriptor_set);
 	m_program->bind_uniform(m_volatile_attribute_storage, "volatile_input_stream", m_current_frame->descriptor_set);
@@ -1889,7 +1926,8 @@ void VKGSRender::advance_queued_frames()
 		return false;
 	});
 
-	m_vertex_cache->purge();
+	m_current_frame->vertex_cache_frame = m_vertex_cache->get_frame_id();
+	m_vertex_cache->on_frame_end();
 	m_current_frame->tag_frame_end(m_attrib_ring_info.get_current_put_pos_minus_one(),
 		m_uniform_buffer_ring_info.get_current_put_pos_minus_one(),
 		m_index_buffer_ring_info.get_current_put_pos_minus_one(),
@@ -1991,6 +2029,9 @@ void VKGSRender::process_swap_request(frame_context_t *ctx, bool free_resources)
 		ctx->buffer_views_to_clean.clear();
 		ctx->samplers_to_clean.clear();
 
+		//Vertex cache heap space released up to this frame is no longer read by the GPU
+		m_vertex_cache->on_frame_retired(ctx->vertex_cache_frame);
+
 		if (ctx->last_frame_sync_time > m_last_heap_sync_time)
 		{
 			m_last_heap_sync_time = ctx->last_frame_sync_time;
@@ -2160,7 +2201,7 @@ bool VKGSRender::check_program_status()
 	return (rsx::method_registers.shader_program_address() != 0);
 }
 
-void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
+bool VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 {
 	get_current_fragment_program(fs_sampler_state);
 	verify(HERE), current_fragment_program.valid;
@@ -2304,10 +2345,55 @@ void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 
 	vk::enter_uninterruptible();
 
+	//The input layout is needed up front to select a layout specialized vertex program
+	s32 vertex_layout_state[64];
+	fill_vertex_layout_state(m_vertex_layout, vertex_count, vertex_layout_state);
+
 	//Load current program from buffer
 	vertex_program.skip_vertex_input_check = true;
+	vertex_program.fetch_layout.set(vertex_layout_state, g_cfg.video.specialized_vertex_fetch);
 	fragment_program.unnormalized_coords = 0;
-	m_program = m_prog_buffer->getGraphicPipelineState(vertex_program, fragment_program, properties, *m_device, pipeline_layout).get();
+	bool program_ready = true;
+	bool use_previous_program = false;
+
+	rsx_vertex_fetch_layout input_layout;
+	input_layout.set(vertex_layout_state, true);
+
+	if (g_cfg.video.async_shader_compilation)
+	{
+		VkDevice dev = *m_device;
+
+		if (auto pipeline = m_prog_buffer->get_graphics_pipeline_async(vertex_program, fragment_program, properties, dev, pipeline_layout))
+		{
+			m_program = pipeline->get();
+		}
+		else
+		{
+			//The previous pipeline can only be used with a compatible render pass, vertex input and topology
+			//Its fragment constants are read from its own ucode, which must still be present
+			use_previous_program = m_program && g_cfg.video.async_shader_fallback &&
+				m_program_renderpass_id == m_current_renderpass_id &&
+				m_program_input_layout == input_layout &&
+				m_program_topology == properties.ia.topology &&
+				m_program_primitive_restart == properties.ia.primitiveRestartEnable &&
+				m_prog_buffer->is_fragment_program_ready(m_program_fragment_program);
+
+			program_ready = use_previous_program;
+		}
+	}
+	else
+	{
+		m_program = m_prog_buffer->getGraphicPipelineState(vertex_program, fragment_program, properties, *m_device, pipeline_layout).get();
+	}
+
+	if (program_ready && !use_previous_program)
+	{
+		m_program_renderpass_id = m_current_renderpass_id;
+		m_program_fragment_program = fragment_program;
+		m_program_input_layout = input_layout;
+		m_program_topology = properties.ia.topology;
+		m_program_primitive_restart = properties.ia.primitiveRestartEnable;
+	}
 
 	if (m_prog_buffer->check_cache_missed())
 	{
@@ -2328,7 +2414,15 @@ void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 
 	vk::leave_uninterruptible();
 
-	const size_t fragment_constants_sz = m_prog_buffer->get_fragment_constants_buffer_size(fragment_program);
+	if (!program_ready)
+	{
+		return false;
+	}
+
+	//Fragment constants layout belongs to the bound program
+	const auto& bound_fragment_program = use_previous_program ? m_program_fragment_program : fragment_program;
+
+	const size_t fragment_constants_sz = m_prog_buffer->get_fragment_constants_buffer_size(bound_fragment_program);
 	const size_t fragment_buffer_sz = fragment_constants_sz + (18 * 4 * sizeof(float));
 	const size_t required_mem = 512 + 8192 + fragment_buffer_sz;
 
@@ -2347,7 +2441,7 @@ void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 	*(reinterpret_cast<f32*>(buf + 136)) = rsx::method_registers.point_size();
 	*(reinterpret_cast<f32*>(buf + 140)) = rsx::method_registers.clip_min();
 	*(reinterpret_cast<f32*>(buf + 144)) = rsx::method_registers.clip_max();
-	fill_vertex_layout_state(m_vertex_layout, vertex_count, reinterpret_cast<s32*>(buf + 160));
+	memcpy(buf + 160, vertex_layout_state, sizeof(vertex_layout_state));
 
 	//Vertex constants
 	buf = buf + 512;
@@ -2357,7 +2451,7 @@ void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 	//Fragment constants
 	buf = buf + 8192;
 	if (fragment_constants_sz)
-		m_prog_buffer->fill_fragment_constants_buffer({ reinterpret_cast<float*>(buf), ::narrow<int>(fragment_constants_sz) }, fragment_program);
+		m_prog_buffer->fill_fragment_constants_buffer({ reinterpret_cast<float*>(buf), ::narrow<int>(fragment_constants_sz) }, bound_fragment_program);
 
 	fill_fragment_state_buffer(buf + fragment_constants_sz, fragment_program);
 	
@@ -2366,6 +2460,8 @@ void VKGSRender::load_program(u32 vertex_count, u32 vertex_base)
 	m_program->bind_uniform({ m_uniform_buffer_ring_info.heap->value, vertex_state_offset, 512 }, SCALE_OFFSET_BIND_SLOT, m_current_frame->descriptor_set);
 	m_program->bind_uniform({ m_uniform_buffer_ring_info.heap->value, vertex_constants_offset, 8192 }, VERTEX_CONSTANT_BUFFERS_BIND_SLOT, m_current_frame->descriptor_set);
 	m_program->bind_uniform({ m_uniform_buffer_ring_info.heap->value, fragment_constants_offset, fragment_buffer_sz }, FRAGMENT_CONSTANT_BUFFERS_BIND_SLOT, m_current_frame->descriptor_set);
+
+	return true;
 }
 
 static const u32 mr_color_offset[rsx::limits::color_buffers_count] =
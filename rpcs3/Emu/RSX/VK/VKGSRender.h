@@ -20,6 +20,7 @@ namespace vk
 {
 	using vertex_cache = rsx::vertex_cache::default_vertex_cache<rsx::vertex_cache::uploaded_range<VkFormat>, VkFormat>;
 	using weak_vertex_cache = rsx::vertex_cache::weak_vertex_cache<VkFormat>;
+	using strict_vertex_cache = rsx::vertex_cache::strict_vertex_cache<VkFormat>;
 	using null_vertex_cache = vertex_cache;
 
 	using shader_cache = rsx::shaders_cache<vk::pipeline_props, VKProgramBuffer>;
@@ -31,6 +32,7 @@ namespace vk
 #define VK_TEXTURE_UPLOAD_RING_BUFFER_SIZE_M 256
 #define VK_UBO_RING_BUFFER_SIZE_M 64
 #define VK_INDEX_RING_BUFFER_SIZE_M 64
+#define VK_VERTEX_CACHE_HEAP_SIZE_M 64
 
 #define VK_MAX_ASYNC_CB_COUNT 64
 #define VK_MAX_ASYNC_FRAMES 2
@@ -146,6 +148,9 @@ struct frame_context_t
 
 	u64 last_frame_sync_time = 0;
 
+	//Vertex cache frame recorded into this context
+	u64 vertex_cache_frame = 0;
+
 	//Copy shareable information
 	void grab_resources(frame_context_t &other)
 	{
@@ -158,6 +163,7 @@ struct frame_context_t
 		ubo_heap_ptr = other.attrib_heap_ptr;
 		index_heap_ptr = other.attrib_heap_ptr;
 		texture_upload_heap_ptr = other.texture_upload_heap_ptr;
+		vertex_cache_frame = other.vertex_cache_frame;
 	}
 
 	//Exchange storage (non-copyable)
@@ -238,7 +244,12 @@ class VKGSRender : public GSRender
 private:
 	VKFragmentProgram m_fragment_prog;
 	VKVertexProgram m_vertex_prog;
-	vk::glsl::program *m_program;
+	vk::glsl::program *m_program = nullptr;
+	size_t m_program_renderpass_id = 0; //Render pass the bound pipeline was built for
+	RSXFragmentProgram m_program_fragment_program = {}; //Fragment program the bound pipeline was built from
+	rsx_vertex_fetch_layout m_program_input_layout = {}; //Vertex input formats the bound pipeline was last used with
+	VkPrimitiveTopology m_program_topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+	VkBool32 m_program_primitive_restart = VK_FALSE;
 
 	vk::texture_cache m_texture_cache;
 	rsx::vk_render_targets m_rtts;
@@ -307,6 +318,7 @@ private:
 	vk::vk_data_heap m_uniform_buffer_ring_info;
 	vk::vk_data_heap m_index_buffer_ring_info;
 	vk::vk_data_heap m_texture_upload_buffer_ring_info;
+	vk::vk_data_heap m_vertex_cache_heap; //Persistent storage of the strict vertex cache, not used as a ring
 
 	std::array<frame_context_t, VK_MAX_ASYNC_FRAMES> frame_context_storage;
 	//Temp frame context to use if the real frame queue is overburdened. Only used for storage
@@ -383,7 +395,7 @@ private:
 	std::tuple<VkPrimitiveTopology, u32, u32, u32, std::optional<std::tuple<VkDeviceSize, VkIndexType> > > upload_vertex_data();
 public:
 	bool check_program_status();
-	void load_program(u32 vertex_count, u32 vertex_base);
+	bool load_program(u32 vertex_count, u32 vertex_base);
 	void init_buffers(rsx::framebuffer_creation_context context, bool skip_reading = false);
 	void read_buffers();
 	void write_buffers();
@@ -79,22 +79,49 @@ struct VKTraits
 	using pipeline_storage_type = std::unique_ptr<vk::glsl::program>;
 	using pipeline_properties = vk::pipeline_props;
 
+	// SPIR-V generation and shader module creation don't need external synchronization
+	static constexpr bool threadsafe_compile = true;
+
 	static
-	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
+	void decompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
 	{
 		fragmentProgramData.Decompile(RSXFP);
 		fragmentProgramData.id = static_cast<u32>(ID);
+	}
+
+	static
+	void compile_fragment_program(fragment_program_type& fragmentProgramData)
+	{
 		fragmentProgramData.Compile();
 	}
 
 	static
-	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
+	void decompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
 	{
 		vertexProgramData.Decompile(RSXVP);
 		vertexProgramData.id = static_cast<u32>(ID);
+	}
+
+	static
+	void compile_vertex_program(vertex_program_type& vertexProgramData)
+	{
 		vertexProgramData.Compile();
 	}
 
+	static
+	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, size_t ID)
+	{
+		decompile_fragment_program(RSXFP, fragmentProgramData, ID);
+		compile_fragment_program(fragmentProgramData);
+	}
+
+	static
+	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, size_t ID)
+	{
+		decompile_vertex_program(RSXVP, vertexProgramData, ID);
+		compile_vertex_program(vertexProgramData);
+	}
+
 	static
 	pipeline_storage_type build_pipeline(const vertex_program_type &vertexProgramData, const fragment_program_type &fragmentProgramData,
 			const vk::pipeline_props &pipelineProperties, VkDevice dev, VkPipelineLayout common_pipeline_layout)
@@ -137,13 +164,17 @@ struct VKTraits
 		ms.pSampleMask = NULL;
 		ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+		//Properties may be a copy made for a compiler thread, do not rely on pAttachments
+		VkPipelineColorBlendStateCreateInfo cs = pipelineProperties.cs;
+		cs.pAttachments = pipelineProperties.att_state;
+
 		VkPipeline pipeline;
 		VkGraphicsPipelineCreateInfo info = {};
 		info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 		info.pVertexInputState = &vi;
 		info.pInputAssemblyState = &pipelineProperties.ia;
 		info.pRasterizationState = &pipelineProperties.rs;
-		info.pColorBlendState = &pipelineProperties.cs;
+		info.pColorBlendState = &cs;
 		info.pMultisampleState = &ms;
 		info.pViewportState = &vp;
 		info.pDepthStencilState = &pipelineProperties.ds;
@@ -267,6 +267,7 @@ VKGSRender::upload_vertex_data()
 	//Do actual vertex upload
 	auto required = calculate_memory_requirements(m_vertex_layout, vertex_count);
 	size_t persistent_offset = UINT64_MAX, volatile_offset = UINT64_MAX;
+	bool persistent_in_cache_heap = false;
 
 	m_persistent_attribute_storage = VK_NULL_HANDLE;
 	m_volatile_attribute_storage = VK_NULL_HANDLE;
@@ -275,11 +276,14 @@ VKGSRender::upload_vertex_data()
 	{
 		//Check if cacheable
 		//Only data in the 'persistent' block may be cached
-		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
+		//The strict vertex cache keeps this data beyond frame boundaries in its own heap
 		bool in_cache = false;
 		bool to_store = false;
 		u32  storage_address = UINT32_MAX;
 
+		const bool own_heap = m_vertex_cache->has_own_heap();
+		const auto cache_heap = own_heap ? m_vertex_cache_heap.heap->value : m_attrib_ring_info.heap->value;
+
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
@@ -288,7 +292,7 @@ VKGSRender::upload_vertex_data()
 			{
 				in_cache = true;
 				m_current_frame->buffer_views_to_clean.push_back(std::make_unique<vk::buffer_view>(*m_device,
-					m_attrib_ring_info.heap->value, VK_FORMAT_R8_UINT, cached->offset_in_heap, required.first));
+					cache_heap, VK_FORMAT_R8_UINT, cached->offset_in_heap, required.first));
 			}
 			else
 			{
@@ -296,13 +300,29 @@ VKGSRender::upload_vertex_data()
 			}
 		}
 
+		if (!in_cache && to_store && own_heap)
+		{
+			const u32 cache_offset = m_vertex_cache->allocate_range(storage_address, VK_FORMAT_R8_UINT, required.first);
+
+			if (cache_offset != UINT32_MAX)
+			{
+				//Written directly into the cache heap below
+				in_cache = true;
+				persistent_in_cache_heap = true;
+				persistent_offset = cache_offset;
+				m_current_frame->buffer_views_to_clean.push_back(std::make_unique<vk::buffer_view>(*m_device,
+					cache_heap, VK_FORMAT_R8_UINT, cache_offset, required.first));
+			}
+		}
+
 		if (!in_cache)
 		{
 			persistent_offset = (u32)m_attrib_ring_info.alloc<256>(required.first);
+			m_vertex_cache->invalidate_heap_range(persistent_offset, required.first);
 			m_current_frame->buffer_views_to_clean.push_back(std::make_unique<vk::buffer_view>(*m_device,
 				m_attrib_ring_info.heap->value, VK_FORMAT_R8_UINT, persistent_offset, required.first));
 
-			if (to_store)
+			if (to_store && !own_heap)
 			{
 				//store ref in vertex cache
 				m_vertex_cache->store_range(storage_address, VK_FORMAT_R8_UINT, required.first, (u32)persistent_offset);
@@ -319,6 +339,7 @@ VKGSRender::upload_vertex_data()
 	if (required.second > 0)
 	{
 		volatile_offset = (u32)m_attrib_ring_info.alloc<256>(required.second);
+		m_vertex_cache->invalidate_heap_range(volatile_offset, required.second);
 		m_current_frame->buffer_views_to_clean.push_back(std::make_unique<vk::buffer_view>(*m_device,
 			m_attrib_ring_info.heap->value, VK_FORMAT_R8_UINT, volatile_offset, required.second));
 
@@ -330,32 +351,45 @@ VKGSRender::upload_vertex_data()
 	}
 
 	//Write all the data once if possible
-	if (required.first && required.second && volatile_offset > persistent_offset)
+	if (persistent_in_cache_heap)
+	{
+		if (required.second > 0)
+		{
+			void *volatile_mapping = m_attrib_ring_info.map(volatile_offset, required.second);
+			write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, nullptr, volatile_mapping);
+			m_attrib_ring_info.unmap();
+		}
+
+		//Left mapped while the upload workers copy persistent data, unmapped by the render thread before the draw
+		void *persistent_mapping = m_vertex_cache_heap.map(persistent_offset, required.first);
+		write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping, nullptr);
+	}
+	else if (required.first && required.second && volatile_offset > persistent_offset)
 	{
 		//Do this once for both to save time on map/unmap cycles
 		const size_t block_end = (volatile_offset + required.second);
 		const size_t block_size = block_end - persistent_offset;
 		const size_t volatile_offset_in_block = volatile_offset - persistent_offset;
 
+		//Left mapped while the upload workers copy persistent data, unmapped by the render thread before the draw
 		void *block_mapping = m_attrib_ring_info.map(persistent_offset, block_size);
 		write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, block_mapping, (char*)block_mapping + volatile_offset_in_block);
-		m_attrib_ring_info.unmap();
 	}
 	else
 	{
-		if (required.first > 0 && persistent_offset != UINT64_MAX)
-		{
-			void *persistent_mapping = m_attrib_ring_info.map(persistent_offset, required.first);
-			write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping, nullptr);
-			m_attrib_ring_info.unmap();
-		}
-
+		//Volatile data goes first so that the persistent block can stay mapped
 		if (required.second > 0)
 		{
 			void *volatile_mapping = m_attrib_ring_info.map(volatile_offset, required.second);
 			write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, nullptr, volatile_mapping);
 			m_attrib_ring_info.unmap();
 		}
+
+		if (required.first > 0 && persistent_offset != UINT64_MAX)
+		{
+			void *persistent_mapping = m_attrib_ring_info.map(persistent_offset, required.first);
+			write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping, nullptr);
+		}
 	}
 
 	return std::make_tuple(result.native_primitive_type, result.vertex_draw_count, result.allocated_vertex_count, result.vertex_index_base, result.index_info);
@@ -186,7 +186,7 @@ void VKVertexDecompilerThread::insertOutputs(std::stringstream & OS, const std::
 void VKVertexDecompilerThread::insertMainStart(std::stringstream & OS)
 {
 	glsl::insert_glsl_legacy_function(OS, glsl::glsl_vertex_program, properties.has_lit_op);
-	glsl::insert_vertex_input_fetch(OS, glsl::glsl_rules_rpirv);
+	glsl::insert_vertex_input_fetch(OS, glsl::glsl_rules_rpirv, true, &rsx_vertex_program.fetch_layout);
 
 	std::string parameters = "";
 	for (int i = 0; i < 16; ++i)
@@ -1,11 +1,16 @@
 #pragma once
 #include "Utilities/VirtualMemory.h"
 #include "Utilities/hash.h"
+#include "Utilities/mutex.h"
 #include "Emu/Memory/vm.h"
 #include "gcm_enums.h"
 #include "Common/ProgramStateCache.h"
 #include "Emu/Cell/Modules/cellMsgDialog.h"
 #include "Emu/System.h"
+#include <unordered_set>
+#include <map>
+#include <deque>
+#include <functional>
 
 namespace rsx
 {
@@ -57,6 +62,9 @@ namespace rsx
 		protect_policy_full_range	//Guard the full memory range. Shared pages may be invalidated by access outside the object we're guarding
 	};
 
+	// Called after a section made its pages writable again (other caches relying on the protection must drop their data)
+	extern std::function<void(u32 base, u32 length)> g_on_section_unprotect;
+
 	class buffered_section
 	{
 	private:
@@ -129,6 +137,11 @@ namespace rsx
 			utils::memory_protect(vm::base(locked_address_base), locked_address_range, prot);
 			protection = prot;
 			locked = prot != utils::protection::rw;
+
+			if (prot == utils::protection::rw && g_on_section_unprotect)
+			{
+				g_on_section_unprotect(locked_address_base, locked_address_range);
+			}
 		}
 
 		void unprotect()
@@ -257,6 +270,8 @@ namespace rsx
 			u64 pipeline_storage_hash;
 
 			u32 vp_ctrl;
+			u32 vp_fetch_specialized;
+			u16 vp_fetch_layout[16];
 
 			u32 fp_ctrl;
 			u32 fp_texture_dimensions;
@@ -272,13 +287,195 @@ namespace rsx
 			pipeline_storage_type pipeline_properties;
 		};
 
+		// Cache archive: header followed by records, appended in order (programs before the pipelines using them)
+		struct archive_header
+		{
+			u64 magic;
+			u32 version;
+			u32 pipeline_data_size;
+		};
+
+		enum record_type : u32
+		{
+			record_vertex_program = 1,
+			record_fragment_program = 2,
+			record_pipeline = 3,
+		};
+
+		struct record_header
+		{
+			u32 type;
+			u32 size;
+			u64 key; // Program hash or pipeline hash
+			u64 checksum;
+			u64 reserved;
+		};
+
+		static constexpr u64 archive_magic = 0x4548434143585352; // "RSXCACHE"
+		static constexpr u32 archive_version = 2;
+
 		std::string version_prefix;
 		std::string root_path;
 		std::string pipeline_class_name;
+		std::unordered_map<u64, std::vector<u32>> vertex_program_data;
 		std::unordered_map<u64, std::vector<u8>> fragment_program_data;
 
+		// Keys of pipelines already stored in the archive
+		std::unordered_set<u64> pipeline_keys;
+
+		fs::file m_archive;
+		u64 m_archive_end = 0;
+
 		backend_storage& m_storage;
 
+		static u64 get_checksum(const void* data, u32 size)
+		{
+			// FNV-1a
+			u64 result = 0xcbf29ce484222325;
+
+			for (u32 i = 0; i < size; i++)
+			{
+				result ^= static_cast<const u8*>(data)[i];
+				result *= 0x100000001b3;
+			}
+
+			return result;
+		}
+
+		std::string get_archive_path() const
+		{
+			return root_path + "/" + pipeline_class_name + "-" + version_prefix + ".bin";
+		}
+
+		// Open archive and read all valid records
+		bool open_archive(std::vector<pipeline_data>& pipelines)
+		{
+			if (m_archive)
+			{
+				return true;
+			}
+
+			if (!fs::is_dir(root_path) && !fs::create_path(root_path))
+			{
+				LOG_ERROR(RSX, "Failed to create shader cache directory %s", root_path);
+				return false;
+			}
+
+			if (!m_archive.open(get_archive_path(), fs::read + fs::write + fs::create))
+			{
+				LOG_ERROR(RSX, "Failed to open shader cache archive %s", get_archive_path());
+				return false;
+			}
+
+			// Read the whole archive at once
+			const std::vector<u8> bytes = m_archive.to_vector<u8>();
+
+			archive_header header{};
+
+			if (bytes.size() >= sizeof(archive_header))
+			{
+				std::memcpy(&header, bytes.data(), sizeof(archive_header));
+			}
+
+			if (header.magic != archive_magic || header.version != archive_version || header.pipeline_data_size != sizeof(pipeline_data))
+			{
+				if (bytes.size())
+				{
+					LOG_ERROR(RSX, "Shader cache archive %s is not compatible with the current shader cache", get_archive_path());
+				}
+
+				header = { archive_magic, archive_version, sizeof(pipeline_data) };
+				m_archive.trunc(0);
+				m_archive.seek(0);
+				m_archive.write(header);
+				m_archive_end = sizeof(archive_header);
+				return true;
+			}
+
+			u64 pos = sizeof(archive_header);
+
+			while (pos + sizeof(record_header) <= bytes.size())
+			{
+				record_header record;
+				std::memcpy(&record, bytes.data() + pos, sizeof(record_header));
+
+				const u64 next = pos + sizeof(record_header) + ::align<u64>(record.size, 16);
+
+				if (next > bytes.size())
+				{
+					LOG_WARNING(RSX, "Shader cache archive is truncated at 0x%llx", pos);
+					break;
+				}
+
+				const u8* data = bytes.data() + pos + sizeof(record_header);
+
+				if (get_checksum(data, record.size) != record.checksum)
+				{
+					LOG_ERROR(RSX, "Shader cache archive record at 0x%llx is corrupted", pos);
+					pos = next;
+					continue;
+				}
+
+				pos = next;
+
+				switch (record.type)
+				{
+				case record_vertex_program:
+				{
+					vertex_program_data[record.key].assign(reinterpret_cast<const u32*>(data), reinterpret_cast<const u32*>(data + record.size));
+					break;
+				}
+				case record_fragment_program:
+				{
+					fragment_program_data[record.key].assign(data, data + record.size);
+					break;
+				}
+				case record_pipeline:
+				{
+					if (record.size == sizeof(pipeline_data) && pipeline_keys.emplace(record.key).second)
+					{
+						pipelines.emplace_back();
+						std::memcpy(&pipelines.back(), data, sizeof(pipeline_data));
+					}
+
+					break;
+				}
+				default:
+				{
+					LOG_ERROR(RSX, "Unknown shader cache archive record (type=%u)", record.type);
+					break;
+				}
+				}
+			}
+
+			m_archive_end = pos;
+			return true;
+		}
+
+		void write_record(u32 type, u64 key, const void* data, u32 size)
+		{
+			record_header record{};
+			record.type = type;
+			record.size = size;
+			record.key = key;
+			record.checksum = get_checksum(data, size);
+
+			// Write the whole record at once
+			std::vector<u8> buffer(sizeof(record_header) + ::align<u64>(size, 16));
+			std::memcpy(buffer.data(), &record, sizeof(record_header));
+			std::memcpy(buffer.data() + sizeof(record_header), data, size);
+
+			m_archive.seek(m_archive_end);
+
+			if (m_archive.write(buffer.data(), buffer.size()) != buffer.size())
+			{
+				LOG_ERROR(RSX, "Failed to write shader cache archive %s", get_archive_path());
+				return;
+			}
+
+			m_archive_end += buffer.size();
+		}
+
 	public:
 
 		struct progress_dialog_helper
@@ -348,31 +545,40 @@ namespace rsx
 				return;
 			}
 
-			std::string directory_path = root_path + "/pipelines/" + pipeline_class_name;
+			std::vector<pipeline_data> pipelines;
 
-			if (!fs::is_dir(directory_path))
+			if (!open_archive(pipelines) || pipelines.empty())
 			{
-				fs::create_path(directory_path);
-				fs::create_path(root_path + "/raw");
-
 				return;
 			}
 
-			fs::dir root = fs::dir(directory_path);
-			fs::dir_entry tmp;
+			using unpacked_type = decltype(unpack(pipelines[0]));
+			std::vector<unpacked_type> unpacked;
+			std::vector<RSXVertexProgram> vertex_programs;
+			std::vector<RSXFragmentProgram> fragment_programs;
 
-			u32 entry_count = 0;
-			for (auto It = root.begin(); It != root.end(); ++It, entry_count++);
+			for (auto& data : pipelines)
+			{
+				if (!vertex_program_data.count(data.vertex_program_hash) || !fragment_program_data.count(data.fragment_program_hash))
+				{
+					LOG_ERROR(RSX, "Cached pipeline object references missing programs (vp=0x%llx, fp=0x%llx)", data.vertex_program_hash, data.fragment_program_hash);
+					continue;
+				}
+
+				unpacked.emplace_back(unpack(data));
+				vertex_programs.emplace_back(std::get<1>(unpacked.back()));
+				fragment_programs.emplace_back(std::get<2>(unpacked.back()));
+			}
 
-			if (entry_count <= 2)
+			if (unpacked.empty())
+			{
 				return;
+			}
 
-			entry_count -= 2;
+			const u32 entry_count = ::size32(unpacked);
 			f32 delta = 100.f / entry_count;
 			f32 tally = 0.f;
 
-			root.rewind();
-
 			// Progress dialog
 			std::unique_ptr<progress_dialog_helper> fallback_dlg;
 			if (!dlg)
@@ -383,31 +589,21 @@ namespace rsx
 
 			dlg->create();
 
-			const auto prefix_length = version_prefix.length();
+			// Decompile unique programs in parallel, only linking remains serialized
+			m_storage.preload_programs(vertex_programs, fragment_programs);
+
 			u32 processed = 0;
-			while (root.read(tmp) && !Emu.IsStopped())
+			for (auto& entry : unpacked)
 			{
-				if (tmp.name == "." || tmp.name == "..")
-					continue;
-
-				if (tmp.name.compare(0, prefix_length, version_prefix) != 0)
-					continue;
-
-				std::vector<u8> bytes;
-				fs::file f(directory_path + "/" + tmp.name);
+				if (Emu.IsStopped())
+				{
+					break;
+				}
 
 				processed++;
 				dlg->update_msg(processed, entry_count);
 
-				if (f.size() != sizeof(pipeline_data))
-				{
-					LOG_ERROR(RSX, "Cached pipeline object %s is not binary compatible with the current shader cache", tmp.name.c_str());
-					continue;
-				}
-
-				f.read<u8>(bytes, f.size());
-				auto unpacked = unpack(*(pipeline_data*)bytes.data());
-				m_storage.add_pipeline_entry(std::get<1>(unpacked), std::get<2>(unpacked), std::get<0>(unpacked), std::forward<Args>(args)...);
+				m_storage.add_pipeline_entry(std::get<1>(entry), std::get<2>(entry), std::get<0>(entry), std::forward<Args>(args)...);
 
 				tally += delta;
 				if (tally > 1.f)
@@ -430,22 +626,17 @@ namespace rsx
 			}
 
 			pipeline_data data = pack(pipeline, vp, fp);
-			std::string fp_name = root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash);
-			std::string vp_name = root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash);
 
-			if (!fs::is_file(fp_name))
-			{
-				const auto size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(fp.addr);
-				fs::file(fp_name, fs::rewrite).write(fp.addr, size);
-			}
+			std::vector<pipeline_data> unused;
 
-			if (!fs::is_file(vp_name))
+			if (!open_archive(unused))
 			{
-				fs::file(vp_name, fs::rewrite).write<u32>(vp.data);
+				return;
 			}
 
 			u64 state_hash = 0;
 			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
+			state_hash ^= get_checksum(&data.vp_fetch_specialized, sizeof(u32) + sizeof(data.vp_fetch_layout));
 			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
 			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
 			state_hash ^= rpcs3::hash_base<u16>(data.fp_unnormalized_coords);
@@ -457,21 +648,37 @@ namespace rsx
 			state_hash ^= rpcs3::hash_base<u16>(data.fp_alphakill_mask);
 			state_hash ^= rpcs3::hash_base<u64>(data.fp_zfunc_mask);
 
-			std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "-" + pipeline_file_name;
-			fs::file(pipeline_path, fs::rewrite).write(&data, sizeof(pipeline_data));
+			const u64 key_data[4] = { data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash };
+			const u64 pipeline_key = get_checksum(key_data, sizeof(key_data));
+
+			if (!pipeline_keys.emplace(pipeline_key).second)
+			{
+				return;
+			}
+
+			// Programs are stored once
+			if (!fragment_program_data.count(data.fragment_program_hash))
+			{
+				const auto size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(fp.addr);
+				auto& fp_data = fragment_program_data[data.fragment_program_hash];
+				fp_data.assign(static_cast<const u8*>(fp.addr), static_cast<const u8*>(fp.addr) + size);
+				write_record(record_fragment_program, data.fragment_program_hash, fp_data.data(), ::size32(fp_data));
+			}
+
+			if (!vertex_program_data.count(data.vertex_program_hash))
+			{
+				auto& vp_data = vertex_program_data[data.vertex_program_hash];
+				vp_data = vp.data;
+				write_record(record_vertex_program, data.vertex_program_hash, vp_data.data(), ::size32(vp_data) * sizeof(u32));
+			}
+
+			write_record(record_pipeline, pipeline_key, &data, sizeof(pipeline_data));
 		}
 
 		RSXVertexProgram load_vp_raw(u64 program_hash)
 		{
-			std::vector<u32> data;
-			std::string filename = fmt::format("%llX.vp", program_hash);
-
-			fs::file f(root_path + "/raw/" + filename);
-			f.read<u32>(data, f.size() / sizeof(u32));
-
 			RSXVertexProgram vp = {};
-			vp.data = data;
+			vp.data = vertex_program_data.at(program_hash);
 			vp.skip_vertex_input_check = true;
 
 			return vp;
@@ -479,15 +686,8 @@ namespace rsx
 
 		RSXFragmentProgram load_fp_raw(u64 program_hash)
 		{
-			std::vector<u8> data;
-			std::string filename = fmt::format("%llX.fp", program_hash);
-
-			fs::file f(root_path + "/raw/" + filename);
-			f.read<u8>(data, f.size());
-
 			RSXFragmentProgram fp = {};
-			fragment_program_data[program_hash] = data;
-			fp.addr = fragment_program_data[program_hash].data();
+			fp.addr = fragment_program_data.at(program_hash).data();
 
 			return fp;
 		}
@@ -499,6 +699,8 @@ namespace rsx
 			pipeline_storage_type pipeline = data.pipeline_properties;
 
 			vp.output_mask = data.vp_ctrl;
+			vp.fetch_layout.specialized = data.vp_fetch_specialized != 0;
+			std::copy(std::begin(data.vp_fetch_layout), std::end(data.vp_fetch_layout), vp.fetch_layout.attributes.begin());
 
 			fp.ctrl = data.fp_ctrl;
 			fp.texture_dimensions = data.fp_texture_dimensions;
@@ -529,6 +731,8 @@ namespace rsx
 			data_block.pipeline_storage_hash = m_storage.get_hash(pipeline);
 
 			data_block.vp_ctrl = vp.output_mask;
+			data_block.vp_fetch_specialized = vp.fetch_layout.specialized;
+			std::copy(vp.fetch_layout.attributes.begin(), vp.fetch_layout.attributes.end(), std::begin(data_block.vp_fetch_layout));
 
 			data_block.fp_ctrl = fp.ctrl;
 			data_block.fp_texture_dimensions = fp.texture_dimensions;
@@ -558,11 +762,32 @@ namespace rsx
 			virtual storage_type* find_vertex_range(uintptr_t /*local_addr*/, upload_format, u32 /*data_length*/) { return nullptr; }
 			virtual void store_range(uintptr_t /*local_addr*/, upload_format, u32 /*data_length*/, u32 /*offset_in_heap*/) {}
 			virtual void purge() {}
+
+			// Source memory was written to or unmapped, returns true if any cached range was affected
+			virtual bool invalidate_range(u32 /*address*/, u32 /*range*/, bool /*unprotect*/) { return false; }
+
+			// Heap space is about to be overwritten by a new allocation
+			virtual void invalidate_heap_range(u32 /*offset_in_heap*/, u32 /*data_length*/) {}
+
+			// Reserve space in the cache's own heap and register the range, returns UINT32_MAX if not stored there
+			virtual u32 allocate_range(uintptr_t /*local_addr*/, upload_format, u32 /*data_length*/) { return UINT32_MAX; }
+
+			// Cached ranges are kept in the cache's own heap instead of the attribute heap
+			virtual bool has_own_heap() const { return false; }
+
+			virtual void on_frame_end() { purge(); }
+
+			// Identifier of the frame being recorded (see on_frame_retired)
+			virtual u64 get_frame_id() const { return 0; }
+
+			// GPU work of the frame has completed, heap space released up to it may be reused
+			virtual void on_frame_retired(u64 /*frame*/) {}
+
+			virtual ~default_vertex_cache() = default;
 		};
 
 		// A weak vertex cache with no data checks or memory range locks
 		// Of limited use since contents are only guaranteed to be valid once per frame
-		// TODO: Strict vertex cache with range locks
 		template <typename upload_format>
 		struct uploaded_range
 		{
@@ -609,5 +834,382 @@ namespace rsx
 				vertex_ranges.clear();
 			}
 		};
+
+		// A vertex cache keeping ranges across frames
+		// Source memory is write protected like texture cache sections, ranges are dropped when it is written to
+		// Cached data is kept in a separate heap owned by the cache (the attribute ring reuses its space every few frames)
+		// Space of dropped ranges is only reused once the GPU work of the frame in which they were dropped has completed
+		template <typename upload_format>
+		class strict_vertex_cache : public default_vertex_cache<uploaded_range<upload_format>, upload_format>
+		{
+			using storage_type = uploaded_range<upload_format>;
+
+			struct cached_range : storage_type
+			{
+				u32 alloc_size;
+				u64 last_used; // Last frame which used the range
+			};
+
+			struct retired_block
+			{
+				u64 frame;
+				u32 offset;
+				u32 size;
+			};
+
+		private:
+			shared_mutex m_mutex;
+			std::map<u32, std::vector<cached_range>> vertex_ranges; // By source address
+			std::unordered_map<u32, u32> locked_pages; // Page address -> number of ranges using it
+			u32 max_data_length = 0;
+			u64 current_frame = 0;
+
+			// Own heap space allocator
+			std::map<u32, u32> free_blocks; // Offset -> size
+			std::deque<retired_block> retired_blocks; // In frame order
+			bool heap_exhausted = false;
+
+			// Pages made writable by the texture cache, ranges using them are dropped before the next lookup
+			// Kept separately: the notification comes with texture cache locks held
+			std::mutex m_unprotected_mutex;
+			std::vector<std::pair<u32, u32>> m_unprotected;
+			atomic_t<bool> m_has_unprotected{ false };
+
+			// Copy of the last hit, the stored entry may be removed by another thread
+			storage_type last_hit = {};
+
+			// Checks whether the texture cache also protects the memory, such pages are left to it
+			std::function<bool(u32, u32)> is_range_locked;
+
+			void lock_pages(u32 address, u32 data_length)
+			{
+				const u32 limit = align(address + data_length, 4096u);
+				u32 run_start = 0, run_length = 0;
+
+				for (u32 page = address & ~4095; page != limit; page += 4096)
+				{
+					if (locked_pages[page]++ == 0)
+					{
+						if (run_length && run_start + run_length == page)
+						{
+							run_length += 4096;
+							continue;
+						}
+
+						if (run_length)
+						{
+							utils::memory_protect(vm::base(run_start), run_length, utils::protection::ro);
+						}
+
+						run_start = page;
+						run_length = 4096;
+					}
+				}
+
+				if (run_length)
+				{
+					utils::memory_protect(vm::base(run_start), run_length, utils::protection::ro);
+				}
+			}
+
+			void unlock_pages(u32 address, u32 data_length, bool unprotect)
+			{
+				const u32 limit = align(address + data_length, 4096u);
+
+				for (u32 page = address & ~4095; page != limit; page += 4096)
+				{
+					const auto found = locked_pages.find(page);
+
+					if (found == locked_pages.end() || --found->second)
+					{
+						continue;
+					}
+
+					locked_pages.erase(found);
+
+					if (unprotect && !is_range_locked(page, 4096))
+					{
+						utils::memory_protect(vm::base(page), 4096, utils::protection::rw);
+					}
+				}
+			}
+
+			u32 heap_alloc(u32 size)
+			{
+				for (auto it = free_blocks.begin(); it != free_blocks.end(); it++)
+				{
+					if (it->second >= size)
+					{
+						const u32 offset = it->first;
+						const u32 remaining = it->second - size;
+
+						free_blocks.erase(it);
+
+						if (remaining)
+						{
+							free_blocks.emplace(offset + size, remaining);
+						}
+
+						return offset;
+					}
+				}
+
+				return UINT32_MAX;
+			}
+
+			void heap_free(u32 offset, u32 size)
+			{
+				// Merge with adjacent free blocks
+				const auto next = free_blocks.lower_bound(offset);
+
+				if (next != free_blocks.end() && offset + size == next->first)
+				{
+					size += next->second;
+					free_blocks.erase(next);
+				}
+
+				const auto prev = free_blocks.lower_bound(offset);
+
+				if (prev != free_blocks.begin() && std::prev(prev)->first + std::prev(prev)->second == offset)
+				{
+					std::prev(prev)->second += size;
+					return;
+				}
+
+				free_blocks.emplace(offset, size);
+			}
+
+			// The range may still be read by the GPU until the current frame has completed
+			void retire(const cached_range& v)
+			{
+				retired_blocks.push_back({ current_frame, v.offset_in_heap, v.alloc_size });
+			}
+
+			template <typename F>
+			bool remove_if(u32 address, u32 range, bool unprotect, F&& pred)
+			{
+				bool result = false;
+
+				auto It = vertex_ranges.lower_bound(address > max_data_length ? address - max_data_length : 0);
+				const auto end = vertex_ranges.lower_bound(address + range);
+
+				while (It != end)
+				{
+					auto& ranges = It->second;
+
+					for (auto v = ranges.begin(); v != ranges.end();)
+					{
+						if (pred(static_cast<const cached_range&>(*v)))
+						{
+							unlock_pages(static_cast<u32>(v->local_address), v->data_length, unprotect);
+							retire(*v);
+							v = ranges.erase(v);
+							result = true;
+						}
+						else
+						{
+							++v;
+						}
+					}
+
+					It = ranges.empty() ? vertex_ranges.erase(It) : std::next(It);
+				}
+
+				return result;
+			}
+
+			bool overlaps_pages(const storage_type& v, u32 base, u32 limit) const
+			{
+				const u32 v_base = static_cast<u32>(v.local_address) & ~4095;
+				const u32 v_limit = align(static_cast<u32>(v.local_address) + v.data_length, 4096u);
+				return v_base < limit && base < v_limit;
+			}
+
+			// Drop ranges whose pages lost the protection (no longer guaranteed to be unchanged)
+			void process_unprotected()
+			{
+				if (!m_has_unprotected)
+				{
+					return;
+				}
+
+				std::vector<std::pair<u32, u32>> unprotected;
+				{
+					std::lock_guard<std::mutex> lock(m_unprotected_mutex);
+					unprotected.swap(m_unprotected);
+					m_has_unprotected = false;
+				}
+
+				writer_lock lock(m_mutex);
+
+				for (const auto& range : unprotected)
+				{
+					const u32 limit = range.first + range.second;
+
+					remove_if(range.first, range.second, true, [&](const cached_range& v)
+					{
+						return overlaps_pages(v, range.first, limit);
+					});
+				}
+			}
+
+		public:
+			strict_vertex_cache(std::function<bool(u32, u32)> is_range_locked, u32 heap_size)
+				: is_range_locked(std::move(is_range_locked))
+			{
+				free_blocks.emplace(0, heap_size);
+
+				g_on_section_unprotect = [this](u32 base, u32 length)
+				{
+					std::lock_guard<std::mutex> lock(m_unprotected_mutex);
+					m_unprotected.emplace_back(base, length);
+					m_has_unprotected = true;
+				};
+			}
+
+			~strict_vertex_cache()
+			{
+				g_on_section_unprotect = nullptr;
+				purge();
+			}
+
+			bool has_own_heap() const override
+			{
+				return true;
+			}
+
+			storage_type* find_vertex_range(uintptr_t local_addr, upload_format fmt, u32 data_length) override
+			{
+				process_unprotected();
+
+				writer_lock lock(m_mutex);
+
+				const auto found = vertex_ranges.find(static_cast<u32>(local_addr));
+				if (found == vertex_ranges.end())
+					return nullptr;
+
+				for (auto &v : found->second)
+				{
+					if (v.buffer_format == fmt && v.data_length == data_length)
+					{
+						v.last_used = current_frame;
+						last_hit = v;
+						return &last_hit;
+					}
+				}
+
+				return nullptr;
+			}
+
+			u32 allocate_range(uintptr_t local_addr, upload_format fmt, u32 data_length) override
+			{
+				const u32 address = static_cast<u32>(local_addr);
+
+				if (!data_length || is_range_locked(address, data_length))
+				{
+					// Do not interfere with texture cache protection
+					return UINT32_MAX;
+				}
+
+				process_unprotected();
+
+				writer_lock lock(m_mutex);
+
+				const u32 alloc_size = align(data_length, 256u);
+				const u32 offset = heap_alloc(alloc_size);
+
+				if (offset == UINT32_MAX)
+				{
+					// Not cached, unused ranges are evicted at the end of the frame
+					heap_exhausted = true;
+					return UINT32_MAX;
+				}
+
+				cached_range v = {};
+				v.buffer_format = fmt;
+				v.data_length = data_length;
+				v.local_address = local_addr;
+				v.offset_in_heap = offset;
+				v.alloc_size = alloc_size;
+				v.last_used = current_frame;
+
+				vertex_ranges[address].push_back(v);
+				max_data_length = std::max(max_data_length, data_length);
+				lock_pages(address, data_length);
+				return offset;
+			}
+
+			bool invalidate_range(u32 address, u32 range, bool unprotect) override
+			{
+				writer_lock lock(m_mutex);
+
+				const u32 base = address & ~4095;
+				const u32 limit = align(address + range, 4096u);
+
+				return remove_if(base, limit - base, unprotect, [&](const cached_range& v)
+				{
+					return overlaps_pages(v, base, limit);
+				});
+			}
+
+			void purge() override
+			{
+				writer_lock lock(m_mutex);
+
+				for (const auto& page : locked_pages)
+				{
+					if (!is_range_locked(page.first, 4096))
+					{
+						utils::memory_protect(vm::base(page.first), 4096, utils::protection::rw);
+					}
+				}
+
+				for (const auto& ranges : vertex_ranges)
+				{
+					for (const auto& v : ranges.second)
+					{
+						retire(v);
+					}
+				}
+
+				locked_pages.clear();
+				vertex_ranges.clear();
+				max_data_length = 0;
+			}
+
+			u64 get_frame_id() const override
+			{
+				return current_frame;
+			}
+
+			void on_frame_end() override
+			{
+				writer_lock lock(m_mutex);
+
+				if (heap_exhausted)
+				{
+					// Evict ranges which haven't been used recently
+					heap_exhausted = false;
+
+					remove_if(0, UINT32_MAX, true, [&](const cached_range& v)
+					{
+						return v.last_used + 30 < current_frame;
+					});
+				}
+
+				current_frame++;
+			}
+
+			void on_frame_retired(u64 frame) override
+			{
+				writer_lock lock(m_mutex);
+
+				while (!retired_blocks.empty() && retired_blocks.front().frame <= frame)
+				{
+					heap_free(retired_blocks.front().offset, retired_blocks.front().size);
+					retired_blocks.pop_front();
+				}
+			}
+		};
 	}
 }
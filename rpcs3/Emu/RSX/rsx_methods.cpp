@@ -1190,6 +1190,12 @@ namespace rsx
 		registers[reg] = value;
 	}
 
+	void rsx_state::decode(u32 reg, const u32* values, u32 count)
+	{
+		verify(HERE), reg + count <= registers.size();
+		std::memcpy(registers.data() + reg, values, count * sizeof(u32));
+	}
+
 	bool rsx_state::test(u32 reg, u32 value) const
 	{
 		return registers[reg] == value;
@@ -189,6 +189,9 @@ namespace rsx
 
 		void decode(u32 reg, u32 value);
 
+		// Writes a run of consecutive registers starting at reg
+		void decode(u32 reg, const u32* values, u32 count);
+
 		bool test(u32 reg, u32 value) const;
 
 		void reset();
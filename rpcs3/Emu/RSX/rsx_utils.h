@@ -82,25 +82,141 @@ namespace rsx
 		return static_cast<u32>((1ULL << 32) >> ::cntlz32(x - 1, true));
 	}
 
-	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
-	*       - Input can be swizzled or linear, bool flag handles conversion to and from
-	*       - It will handle any width and height that are a power of 2, square or non square
-	*	 Restriction: It has mixed results if the height or width is not a power of 2
-	*/
-	template<typename T>
-	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, bool input_is_swizzled)
+	static inline bool is_pow2(u32 x)
+	{
+		return x && !(x & (x - 1));
+	}
+
+	//Spreads the low 16 bits of value to the even bit positions
+	static inline u32 morton_spread(u32 value)
+	{
+		value &= 0xffff;
+		value = (value | (value << 8)) & 0x00ff00ff;
+		value = (value | (value << 4)) & 0x0f0f0f0f;
+		value = (value | (value << 2)) & 0x33333333;
+		value = (value | (value << 1)) & 0x55555555;
+		return value;
+	}
+
+	//Offset of texel (x, y) in a swizzled texture whose smaller dimension is 1 << log2min
+	static inline u32 get_swizzled_offset(u32 x, u32 y, u32 log2min)
 	{
-		u32 log2width = ceil_log2(width);
-		u32 log2height = ceil_log2(height);
+		const u32 low_mask = (1u << log2min) - 1;
+
+		//Only the larger dimension has bits above log2min; those are stored linearly after the interleaved part
+		return morton_spread(x & low_mask) | (morton_spread(y & low_mask) << 1) | (((x | y) >> log2min) << (log2min << 1));
+	}
+
+	/**
+	 * Morton order stores every 2x2 quad contiguously, so a 4x4 tile is 16 consecutive texels made of 4 quads.
+	 * Row y of the tile starts at texel ((y & 2) << 2) + ((y & 1) << 1) and covers texels {0, 1, 4, 5} from there.
+	 */
+	template<typename T, typename U>
+	static inline void deswizzle_tile_4x4(T* dst, const U* src, u32 dst_pitch)
+	{
+		for (u32 y = 0; y < 4; ++y)
+		{
+			const U* quad = src + ((y & 2) << 2) + ((y & 1) << 1);
+			T* row = dst + y * dst_pitch;
+			row[0] = quad[0];
+			row[1] = quad[1];
+			row[2] = quad[4];
+			row[3] = quad[5];
+		}
+	}
+
+	static inline void deswizzle_tile_4x4(u32* dst, const u32* src, u32 dst_pitch)
+	{
+		const __m128i* in = reinterpret_cast<const __m128i*>(src);
+		const __m128i q0 = _mm_loadu_si128(in);
+		const __m128i q1 = _mm_loadu_si128(in + 1);
+		const __m128i q2 = _mm_loadu_si128(in + 2);
+		const __m128i q3 = _mm_loadu_si128(in + 3);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(q0, q1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_pitch), _mm_unpackhi_epi64(q0, q1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_pitch * 2), _mm_unpacklo_epi64(q2, q3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_pitch * 3), _mm_unpackhi_epi64(q2, q3));
+	}
+
+	static inline void deswizzle_tile_4x4(u16* dst, const be_t<u16>* src, u32 dst_pitch)
+	{
+		const __m128i* in = reinterpret_cast<const __m128i*>(src);
+		__m128i q0 = _mm_loadu_si128(in);
+		__m128i q1 = _mm_loadu_si128(in + 1);
+
+		//Byteswap, then gather the texel pairs of rows 0/1 and 2/3 into the low and high halves
+		q0 = _mm_shuffle_epi32(_mm_or_si128(_mm_slli_epi16(q0, 8), _mm_srli_epi16(q0, 8)), _MM_SHUFFLE(3, 1, 2, 0));
+		q1 = _mm_shuffle_epi32(_mm_or_si128(_mm_slli_epi16(q1, 8), _mm_srli_epi16(q1, 8)), _MM_SHUFFLE(3, 1, 2, 0));
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst), q0);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + dst_pitch), _mm_unpackhi_epi64(q0, q0));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + dst_pitch * 2), q1);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + dst_pitch * 3), _mm_unpackhi_epi64(q1, q1));
+	}
+
+	template<typename T, typename U>
+	static inline void swizzle_tile_4x4(T* dst, const U* src, u32 src_pitch)
+	{
+		for (u32 y = 0; y < 4; ++y)
+		{
+			T* quad = dst + ((y & 2) << 2) + ((y & 1) << 1);
+			const U* row = src + y * src_pitch;
+			quad[0] = row[0];
+			quad[1] = row[1];
+			quad[4] = row[2];
+			quad[5] = row[3];
+		}
+	}
+
+	static inline void swizzle_tile_4x4(u32* dst, const u32* src, u32 src_pitch)
+	{
+		const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_pitch));
+		const __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_pitch * 2));
+		const __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_pitch * 3));
+
+		__m128i* out = reinterpret_cast<__m128i*>(dst);
+		_mm_storeu_si128(out, _mm_unpacklo_epi64(r0, r1));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi64(r0, r1));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi64(r2, r3));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi64(r2, r3));
+	}
+
+	/**
+	 * Deswizzles a texture into a linear destination with a row pitch of dst_pitch texels.
+	 * Power of 2 textures of at least 4x4 texels are processed in 4x4 tiles, anything else falls back to per texel carry arithmetic.
+	 * Assignment from U to T performs any required conversion (e.g. from big endian).
+	 */
+	template<typename T, typename U>
+	void convert_swizzled_to_linear(T* dst, const U* src, u16 width, u16 height, u32 dst_pitch)
+	{
+		const u32 log2width = ceil_log2(width);
+		const u32 log2height = ceil_log2(height);
+		const u32 log2min = std::min(log2width, log2height);
+
+		if (is_pow2(width) && is_pow2(height) && log2min >= 2)
+		{
+			for (u32 y = 0; y < height; y += 4)
+			{
+				T* dst_row = dst + y * dst_pitch;
+
+				for (u32 x = 0; x < width; x += 4)
+				{
+					deswizzle_tile_4x4(dst_row + x, src + get_swizzled_offset(x, y, log2min), dst_pitch);
+				}
+			}
+
+			return;
+		}
 
 		// Max mask possible for square texture
 		u32 x_mask = 0x55555555;
 		u32 y_mask = 0xAAAAAAAA;
 
 		// We have to limit the masks to the lower of the two dimensions to allow for non-square textures
-		u32 limit_mask = (log2width < log2height) ? log2width : log2height;
 		// double the limit mask to account for bits in both x and y
-		limit_mask = 1 << (limit_mask << 1);
+		const u32 limit_mask = 1 << (log2min << 1);
 
 		//x_mask, bits above limit are 1's for x-carry
 		x_mask = (x_mask | ~(limit_mask - 1));
@@ -112,49 +228,102 @@ namespace rsx
 		u32 offs_x0 = 0; //total y-carry offset for x
 		u32 y_incr = limit_mask;
 
-		if (!input_is_swizzled)
+		for (int y = 0; y < height; ++y)
 		{
-			for (int y = 0; y < height; ++y)
-			{
-				T *src = static_cast<T*>(input_pixels) + y * width;
-				T *dst = static_cast<T*>(output_pixels) + offs_y;
-				offs_x = offs_x0;
+			const U *src_row = src + offs_y;
+			T *dst_row = dst + y * dst_pitch;
+			offs_x = offs_x0;
 
-				for (int x = 0; x < width; ++x)
-				{
-					dst[offs_x] = src[x];
-					offs_x = (offs_x - x_mask) & x_mask;
-				}
+			for (int x = 0; x < width; ++x)
+			{
+				dst_row[x] = src_row[offs_x];
+				offs_x = (offs_x - x_mask) & x_mask;
+			}
 
-				offs_y = (offs_y - y_mask) & y_mask;
+			offs_y = (offs_y - y_mask) & y_mask;
 
-				if (offs_y == 0)
-				{
-					offs_x0 += y_incr;
-				}
+			if (offs_y == 0)
+			{
+				offs_x0 += y_incr;
 			}
 		}
-		else
+	}
+
+	/**
+	 * Swizzles a linear texture with a row pitch of src_pitch texels.
+	 * Same tiling rules as convert_swizzled_to_linear.
+	 */
+	template<typename T, typename U>
+	void convert_linear_to_swizzled(T* dst, const U* src, u16 width, u16 height, u32 src_pitch)
+	{
+		const u32 log2width = ceil_log2(width);
+		const u32 log2height = ceil_log2(height);
+		const u32 log2min = std::min(log2width, log2height);
+
+		if (is_pow2(width) && is_pow2(height) && log2min >= 2)
 		{
-			for (int y = 0; y < height; ++y)
+			for (u32 y = 0; y < height; y += 4)
 			{
-				T *src = static_cast<T*>(input_pixels) + offs_y;
-				T *dst = static_cast<T*>(output_pixels) + y * width;
-				offs_x = offs_x0;
+				const U* src_row = src + y * src_pitch;
 
-				for (int x = 0; x < width; ++x)
+				for (u32 x = 0; x < width; x += 4)
 				{
-					dst[x] = src[offs_x];
-					offs_x = (offs_x - x_mask) & x_mask;
+					swizzle_tile_4x4(dst + get_swizzled_offset(x, y, log2min), src_row + x, src_pitch);
 				}
+			}
 
-				offs_y = (offs_y - y_mask) & y_mask;
+			return;
+		}
 
-				if (offs_y == 0)
-				{
-					offs_x0 += y_incr;
-				}
+		u32 x_mask = 0x55555555;
+		u32 y_mask = 0xAAAAAAAA;
+
+		const u32 limit_mask = 1 << (log2min << 1);
+
+		x_mask = (x_mask | ~(limit_mask - 1));
+		y_mask = (y_mask & (limit_mask - 1));
+
+		u32 offs_y = 0;
+		u32 offs_x = 0;
+		u32 offs_x0 = 0;
+		u32 y_incr = limit_mask;
+
+		for (int y = 0; y < height; ++y)
+		{
+			const U *src_row = src + y * src_pitch;
+			T *dst_row = dst + offs_y;
+			offs_x = offs_x0;
+
+			for (int x = 0; x < width; ++x)
+			{
+				dst_row[offs_x] = src_row[x];
+				offs_x = (offs_x - x_mask) & x_mask;
 			}
+
+			offs_y = (offs_y - y_mask) & y_mask;
+
+			if (offs_y == 0)
+			{
+				offs_x0 += y_incr;
+			}
+		}
+	}
+
+	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
+	*       - Input can be swizzled or linear, bool flag handles conversion to and from
+	*       - It will handle any width and height that are a power of 2, square or non square
+	*	 Restriction: It has mixed results if the height or width is not a power of 2
+	*/
+	template<typename T>
+	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, bool input_is_swizzled)
+	{
+		if (input_is_swizzled)
+		{
+			convert_swizzled_to_linear(static_cast<T*>(output_pixels), static_cast<const T*>(input_pixels), width, height, width);
+		}
+		else
+		{
+			convert_linear_to_swizzled(static_cast<T*>(output_pixels), static_cast<const T*>(input_pixels), width, height, width);
 		}
 	}
 
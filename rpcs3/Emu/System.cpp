@@ -39,6 +39,7 @@ extern u64 get_system_time();
 
 extern void ppu_load_exec(const ppu_exec_object&);
 extern void spu_load_exec(const spu_exec_object&);
+extern void spu_db_prepare();
 extern std::shared_ptr<struct lv2_prx> ppu_load_prx(const ppu_prx_object&, const std::string&);
 
 extern void network_thread_init();
@@ -422,6 +423,9 @@ void Emulator::Load(bool add_only)
 		fxm::check_unlocked<patch_engine>()->append(fs::get_config_dir() + "data/" + m_title_id + "/patch.yml");
 		fxm::check_unlocked<patch_engine>()->append(m_cache_path + "/patch.yml");
 
+		// Hash the executable for the SPU database in background
+		spu_db_prepare();
+
 		// Mount all devices
 		const std::string emu_dir = GetEmuDir();
 		const std::string home_dir = g_cfg.vfs.app_home;
@@ -673,6 +677,7 @@ void Emulator::Load(bool add_only)
 			// PS3 executable
 			m_state = system_state::ready;
 			GetCallbacks().on_ready();
+			lv2_obj::init();
 
 			vm::init();
 
@@ -722,6 +727,7 @@ void Emulator::Load(bool add_only)
 			// PPU PRX (experimental)
 			m_state = system_state::ready;
 			GetCallbacks().on_ready();
+			lv2_obj::init();
 			vm::init();
 			ppu_load_prx(ppu_prx, m_path);
 		}
@@ -730,6 +736,7 @@ void Emulator::Load(bool add_only)
 			// SPU executable (experimental)
 			m_state = system_state::ready;
 			GetCallbacks().on_ready();
+			lv2_obj::init();
 			vm::init();
 			spu_load_exec(spu_exec);
 		}
@@ -303,6 +303,10 @@ struct cfg_root : cfg::node
 		cfg::_int<0, 6> preferred_spu_threads{this, "Preferred SPU Threads", 0}; //Numnber of hardware threads dedicated to heavy simultaneous spu tasks
 		cfg::_int<0, 16> spu_delay_penalty{this, "SPU delay penalty", 3}; //Number of milliseconds to block a thread if a virtual 'core' isn't free
 		cfg::_bool spu_loop_detection{this, "SPU loop detection", true}; //Try to detect wait loops and trigger thread yield
+		cfg::_bool spu_reservation_wait{this, "SPU reservation wait", false}; // Sleep on repeated GETLLAR until the reservation line is modified
+		cfg::_int<0, 16> spu_compile_threads{this, "SPU Compile Threads", 0}; // Compile SPU functions in background (0: compile on SPU threads)
+		cfg::_bool spu_dma_batching{this, "SPU DMA list batching", true}; // Merge contiguous DMA list elements into single transfers
+		cfg::_int<0, 65536> spu_dma_stream_threshold{this, "SPU DMA streaming threshold", 16384}; // Minimal DMA PUT size using non-temporal stores (0: disabled)
 
 		cfg::_enum<lib_loading_type> lib_loading{this, "Lib Loader", lib_loading_type::liblv2only};
 		cfg::_bool hook_functions{this, "Hook static functions"};
@@ -351,9 +355,14 @@ struct cfg_root : cfg::node
 		cfg::_bool strict_rendering_mode{this, "Strict Rendering Mode"};
 		cfg::_bool disable_zcull_queries{this, "Disable ZCull Occlusion Queries", false};
 		cfg::_bool disable_vertex_cache{this, "Disable Vertex Cache", false};
+		cfg::_bool strict_vertex_cache{this, "Strict Vertex Cache", false}; // Keep vertex data across frames using memory protection
+		cfg::_int<0, 8> vertex_upload_threads{this, "Vertex Upload Threads", 0}; // Copy large vertex blocks on worker threads, 0 to disable
 		cfg::_bool frame_skip_enabled{this, "Enable Frame Skip", false};
 		cfg::_bool force_cpu_blit_processing{this, "Force CPU Blit", false}; // Debugging option
 		cfg::_bool disable_on_disk_shader_cache{this, "Disable On-Disk Shader Cache", false};
+		cfg::_bool async_shader_compilation{this, "Asynchronous Shader Compilation", false};
+		cfg::_bool async_shader_fallback{this, "Draw With Previous Shader While Compiling", false}; // Otherwise the draw is skipped
+		cfg::_bool specialized_vertex_fetch{this, "Specialized Vertex Fetch", false}; // Compile vertex input decoding for the active vertex layout
 		cfg::_int<1, 8> consequtive_frames_to_draw{this, "Consecutive Frames To Draw", 1};
 		cfg::_int<1, 8> consequtive_frames_to_skip{this, "Consecutive Frames To Skip", 1};
 		cfg::_int<50, 800> resolution_scale_percent{this, "Resolution Scale", 100};